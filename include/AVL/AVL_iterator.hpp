@@ -4,25 +4,24 @@
 
 #include "AVL_tree_fwd.hpp"
 
-template <typename KeyT, typename ComparatorT>
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
 template <typename Ref>
-AVL_tree_t<KeyT, ComparatorT>::AVL_tree_iterator<Ref>::AVL_tree_iterator(
+AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::AVL_tree_iterator<Ref>::AVL_tree_iterator(
   TreeRef    tree,
   node_ind_t cur_node_ind
 ) : tree_(tree), cur_node_ind_(cur_node_ind) {}
 
-template <typename KeyT, typename ComparatorT>
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
 template <typename Ref>
-auto AVL_tree_t<KeyT, ComparatorT>::AVL_tree_iterator<Ref>::navigate(
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::AVL_tree_iterator<Ref>::navigate(
   iterator_move_dir_t direction
 ) -> AVL_tree_iterator<Ref>& {
   bool is_forward_dir = direction == iterator_move_dir_t::kForward;
   auto node_kid_getter = [this, is_forward_dir](node_ind_t node_ind){
-    const node_t& cur_node = tree_.get_node(node_ind);
     if (is_forward_dir) {
-      return cur_node.right;
+      return tree_.nodes_buffer_.right(node_ind);
     } else {
-      return cur_node.left;
+      return tree_.nodes_buffer_.left(node_ind);
     }
   };
 
@@ -34,10 +33,10 @@ auto AVL_tree_t<KeyT, ComparatorT>::AVL_tree_iterator<Ref>::navigate(
       : get_rightmost_node(tree_, kid_node_ind);
   } else {
     // no right child - go up until we come from left side
-    node_ind_t parent = tree_.get_node(cur_node_ind_).parent;
+    node_ind_t parent = tree_.nodes_buffer_.parent(cur_node_ind_);
     while (parent != kNullNodeInd && cur_node_ind_ == node_kid_getter(parent)) {
       cur_node_ind_ = parent;
-      parent = tree_.get_node(cur_node_ind_).parent;
+      parent = tree_.nodes_buffer_.parent(cur_node_ind_);
     }
     cur_node_ind_ = parent;
   }
@@ -48,9 +47,9 @@ auto AVL_tree_t<KeyT, ComparatorT>::AVL_tree_iterator<Ref>::navigate(
   return *this;
 }
 
-template <typename KeyT, typename ComparatorT>
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
 template <typename Ref>
-auto AVL_tree_t<KeyT, ComparatorT>::AVL_tree_iterator<Ref>::
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::AVL_tree_iterator<Ref>::
     operator++() -> AVL_tree_iterator<Ref>& {
   if (*this == tree_.end()) {
     // technically this is UB:
@@ -62,9 +61,9 @@ auto AVL_tree_t<KeyT, ComparatorT>::AVL_tree_iterator<Ref>::
   return navigate(iterator_move_dir_t::kForward);
 }
 
-template <typename KeyT, typename ComparatorT>
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
 template <typename Ref>
-auto AVL_tree_t<KeyT, ComparatorT>::AVL_tree_iterator<Ref>::
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::AVL_tree_iterator<Ref>::
 operator--() -> AVL_tree_iterator<Ref>& {
   if (*this == tree_.end()) {
     cur_node_ind_ = get_rightmost_node(tree_, tree_.root_node_ind_);
@@ -74,79 +73,63 @@ operator--() -> AVL_tree_iterator<Ref>& {
   return navigate(iterator_move_dir_t::kBackward);
 }
 
-template <typename KeyT, typename ComparatorT>
-auto AVL_tree_t<KeyT, ComparatorT>::begin() -> iterator {
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::begin() -> iterator {
   return iterator{
     *this, iterator::get_leftmost_node(*this, root_node_ind_)
   };
 }
 
-template <typename KeyT, typename ComparatorT>
-auto AVL_tree_t<KeyT, ComparatorT>::begin() const -> const_iterator {
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::begin() const -> const_iterator {
   return const_iterator{
     *this, const_iterator::get_leftmost_node(*this, root_node_ind_)
   };
 }
 
-template <typename KeyT, typename ComparatorT>
-auto AVL_tree_t<KeyT, ComparatorT>::end() -> iterator {
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::end() -> iterator {
   return iterator{
     *this, kEndSentinel
   };
 }
 
-template <typename KeyT, typename ComparatorT>
-auto AVL_tree_t<KeyT, ComparatorT>::end() const -> const_iterator {
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::end() const -> const_iterator {
   return const_iterator{
     *this, kEndSentinel
   };
 }
 
-template <typename KeyT, typename ComparatorT>
-auto AVL_tree_t<KeyT, ComparatorT>::cbegin() const -> const_iterator {
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::cbegin() const -> const_iterator {
   return begin();
 }
 
-template <typename KeyT, typename ComparatorT>
-auto AVL_tree_t<KeyT, ComparatorT>::cend()
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::cend()
     const -> const_iterator {
   return end();
 }
 
-template <typename KeyT, typename ComparatorT>
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
 template <typename Ref>
-std::size_t AVL_tree_t<KeyT, ComparatorT>::AVL_tree_iterator<Ref>::
+std::size_t AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::AVL_tree_iterator<Ref>::
 get_cnt_keys_less_or_eq() const {
   // LOG_DEBUG_VARS(cur_node_ind_);
   if (cur_node_ind_ == kEndSentinel) { // this is end() iterator
-    return tree_.nodes_buffer_.size();
+    return tree_.size() + 1;
   }
 
-  std::size_t cnt_keys_less_or_eq = 0;
-  node_ind_t node_ind = cur_node_ind_;
-  bool last_is_left_child = false;
-  while (node_ind != kNullNodeInd) {
-    node_ind_t left_son = tree_.get_node(node_ind).left;
-    if (!last_is_left_child) {
-      cnt_keys_less_or_eq += tree_.get_node_subtree_size(left_son);
-      ++cnt_keys_less_or_eq;
-    }
-    last_is_left_child = false;
-
-    node_ind_t parent = tree_.get_node(node_ind).parent;
-    if (parent != kNullNodeInd &&
-        tree_.get_node(parent).left == node_ind) {
-      last_is_left_child = true;
-    }
-    node_ind = parent;
-  }
-
-  return cnt_keys_less_or_eq;
+  // top-down descent from root, so parent links are not needed here
+  return tree_.count_keys_before(
+    tree_.root_node_ind_, tree_.nodes_buffer_.key(cur_node_ind_), true
+  );
 }
 
-template <typename KeyT, typename ComparatorT>
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
 template <typename Ref>
-std::size_t AVL_tree_t<KeyT, ComparatorT>::AVL_tree_iterator<Ref>::
+std::size_t AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::AVL_tree_iterator<Ref>::
     operator-(const AVL_tree_iterator& other) const {
   // assert(false && "Not implemented yet");
 
@@ -159,35 +142,80 @@ std::size_t AVL_tree_t<KeyT, ComparatorT>::AVL_tree_iterator<Ref>::
   return less_than_finish - less_than_start;
 }
 
-template <typename KeyT, typename ComparatorT>
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+template <typename Ref>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::AVL_tree_iterator<Ref>::
+    operator+=(std::ptrdiff_t offset) -> AVL_tree_iterator<Ref>& {
+  // 0-indexed position of current key, end() is at position size()
+  std::ptrdiff_t position = static_cast<std::ptrdiff_t>(get_cnt_keys_less_or_eq()) - 1;
+  std::ptrdiff_t new_position = position + offset;
+  const bool is_in_range = new_position >= 0 &&
+                           new_position <= static_cast<std::ptrdiff_t>(tree_.size());
+  if (!is_in_range) {
+    // technically this is UB:
+    std::cerr << kIteratorJumpOutOfRangeErrMsg << std::endl;
+    assert(is_in_range);
+    return *this;
+  }
+
+  cur_node_ind_ = tree_.select_node(static_cast<std::size_t>(new_position));
+  return *this;
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+template <typename Ref>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::AVL_tree_iterator<Ref>::
+    operator-=(std::ptrdiff_t offset) -> AVL_tree_iterator<Ref>& {
+  return *this += -offset;
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+template <typename Ref>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::AVL_tree_iterator<Ref>::
+    operator+(std::ptrdiff_t offset) const -> AVL_tree_iterator<Ref> {
+  AVL_tree_iterator<Ref> result = *this;
+  result += offset;
+  return result;
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+template <typename Ref>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::AVL_tree_iterator<Ref>::
+    operator-(std::ptrdiff_t offset) const -> AVL_tree_iterator<Ref> {
+  AVL_tree_iterator<Ref> result = *this;
+  result -= offset;
+  return result;
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
 template <typename Ref>
-Ref AVL_tree_t<KeyT, ComparatorT>::AVL_tree_iterator<Ref>::
+Ref AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::AVL_tree_iterator<Ref>::
     operator*() {
-  return tree_.get_node(cur_node_ind_).key;
+  return tree_.nodes_buffer_.key(cur_node_ind_);
 }
 
-template <typename KeyT, typename ComparatorT>
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
 template <typename Ref>
-bool AVL_tree_t<KeyT, ComparatorT>::AVL_tree_iterator<Ref>::
+bool AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::AVL_tree_iterator<Ref>::
     operator==(const AVL_tree_iterator& other) const {
   return cur_node_ind_ == other.cur_node_ind_ &&
          &tree_        == &other.tree_;
 }
 
 
-template <typename KeyT, typename ComparatorT>
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
 template <typename Ref>
-bool AVL_tree_t<KeyT, ComparatorT>::AVL_tree_iterator<Ref>::
+bool AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::AVL_tree_iterator<Ref>::
     operator!=(const AVL_tree_iterator& other) const {
   return !(*this == other);
 }
 
 // ================    PRIVATE METHODS   ========================
 
-template <typename KeyT, typename ComparatorT>
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
 template <typename Ref>
 template <typename GetKidFunc>
-auto AVL_tree_t<KeyT, ComparatorT>::AVL_tree_iterator<Ref>::
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::AVL_tree_iterator<Ref>::
 get_extreme_node(
   node_ind_t        start_node_ind,
   GetKidFunc        get_kid_func
@@ -204,28 +232,28 @@ get_extreme_node(
   return start_node_ind;
 }
 
-template <typename KeyT, typename ComparatorT>
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
 template <typename Ref>
-auto AVL_tree_t<KeyT, ComparatorT>::AVL_tree_iterator<Ref>::
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::AVL_tree_iterator<Ref>::
 get_leftmost_node(
   TreeRef    tree,
   node_ind_t start_node_ind
 ) -> node_ind_t {
   return get_extreme_node(
     start_node_ind,
-    [&tree](node_ind_t node_ind){ return tree.get_node(node_ind).left; }
+    [&tree](node_ind_t node_ind){ return tree.nodes_buffer_.left(node_ind); }
   );
 }
 
-template <typename KeyT, typename ComparatorT>
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
 template <typename Ref>
-auto AVL_tree_t<KeyT, ComparatorT>::AVL_tree_iterator<Ref>::
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::AVL_tree_iterator<Ref>::
 get_rightmost_node(
   TreeRef    tree,
   node_ind_t start_node_ind
 ) -> node_ind_t {
   return get_extreme_node(
     start_node_ind,
-    [&tree](node_ind_t node_ind){ return tree.get_node(node_ind).right; }
+    [&tree](node_ind_t node_ind){ return tree.nodes_buffer_.right(node_ind); }
   );
 }
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Storage policies for nodes of AVL_tree_t, selected by tag (last template parameter of tree).
+// Nodes are addressed by index, index 0 is reserved for null node, so real nodes have indices >= 1.
+//   * aos_storage_tag - array of structs: all fields of node are kept together in one node_t
+//   * soa_storage_tag - struct of arrays: hot fields (key, sons) that are read by every descent
+//                       are kept in separate tightly packed arrays, subtree sizes and
+//                       rebalancing data (height, parent) live in their own arrays
+struct aos_storage_tag {};
+struct soa_storage_tag {};
+
+template <typename KeyT, typename NodeIndT, typename StorageTagT>
+class AVL_node_storage_t;
+
+// ===========================   ARRAY OF STRUCTS   ===========================
+
+template <typename KeyT, typename NodeIndT>
+class AVL_node_storage_t<KeyT, NodeIndT, aos_storage_tag> {
+ public:
+  using node_ind_t    = NodeIndT;
+  using node_height_t = std::int8_t;
+
+ private:
+  // AVL tree of height 64 has more than 10^13 nodes, so 6 bits are always enough for height
+  static constexpr int        kHeightBits = 6;
+  static constexpr node_ind_t kHeightMask = (node_ind_t{1} << kHeightBits) - 1;
+
+ public:
+  // index -1 is reserved for end sentinel, subtree size has to fit into the rest of bits
+  static constexpr std::size_t max_size() {
+    return (std::numeric_limits<node_ind_t>::max() >> kHeightBits) - 1;
+  }
+
+  std::size_t size() const { return nodes_.size(); }
+
+  std::size_t capacity() const { return nodes_.capacity(); }
+
+  // bytes of memory, that single node slot takes
+  static constexpr std::size_t node_bytes() { return sizeof(node_t); }
+
+  void reserve(std::size_t capacity) { nodes_.reserve(capacity); }
+
+  void clear() { nodes_ = {{}}; }
+
+  // hints cache to load node, that will be read soon, null node is valid address too
+  void prefetch(node_ind_t node_ind) const {
+    __builtin_prefetch(nodes_.data() + node_ind);
+  }
+
+  // appends leaf node and returns its index
+  node_ind_t emplace_back(const KeyT& key) {
+    nodes_.emplace_back(key);
+    return static_cast<node_ind_t>(nodes_.size() - 1);
+  }
+
+  void reset(node_ind_t node_ind, const KeyT& key) { at(node_ind) = node_t(key); }
+
+  void reset(node_ind_t node_ind) { at(node_ind) = node_t(); }
+
+        KeyT& key(node_ind_t node_ind)       { return at(node_ind).key; }
+  const KeyT& key(node_ind_t node_ind) const { return at(node_ind).key; }
+
+  node_ind_t& left  (node_ind_t node_ind)       { return at(node_ind).sons[0]; }
+  node_ind_t  left  (node_ind_t node_ind) const { return at(node_ind).sons[0]; }
+  node_ind_t& right (node_ind_t node_ind)       { return at(node_ind).sons[1]; }
+  node_ind_t  right (node_ind_t node_ind) const { return at(node_ind).sons[1]; }
+  // son is selected by index, so descent needs no branch on comparison result
+  node_ind_t  son   (node_ind_t node_ind, bool is_right) const { return at(node_ind).sons[is_right]; }
+  node_ind_t& parent(node_ind_t node_ind)       { return at(node_ind).parent; }
+  node_ind_t  parent(node_ind_t node_ind) const { return at(node_ind).parent; }
+
+  node_height_t height(node_ind_t node_ind) const {
+    return static_cast<node_height_t>(at(node_ind).height_and_size & kHeightMask);
+  }
+
+  std::size_t subtree_size(node_ind_t node_ind) const {
+    return at(node_ind).height_and_size >> kHeightBits;
+  }
+
+  void set_height(node_ind_t node_ind, node_height_t height) {
+    node_ind_t& height_and_size = at(node_ind).height_and_size;
+    height_and_size = (height_and_size & ~kHeightMask) | static_cast<node_ind_t>(height);
+  }
+
+  void set_subtree_size(node_ind_t node_ind, std::size_t subtree_size) {
+    node_ind_t& height_and_size = at(node_ind).height_and_size;
+    height_and_size = (static_cast<node_ind_t>(subtree_size) << kHeightBits) |
+                      (height_and_size & kHeightMask);
+  }
+
+  void shift_subtree_size(node_ind_t node_ind, std::ptrdiff_t size_delta) {
+    at(node_ind).height_and_size += static_cast<node_ind_t>(size_delta) << kHeightBits;
+  }
+
+ private:
+  class node_t {
+   public:
+    KeyT                      key{};
+    std::array<node_ind_t, 2> sons{}; // left and right
+    node_ind_t                parent{};
+    // height is packed into low bits, subtree size occupies the rest
+    node_ind_t                height_and_size{};
+
+    node_t() = default;
+    node_t(const KeyT& key)
+      : key(key), height_and_size((node_ind_t{1} << kHeightBits) | 1) {}
+  };
+
+  node_t& at(node_ind_t node_ind) {
+    assert(node_ind != 0 && node_ind < nodes_.size());
+    return nodes_[node_ind];
+  }
+
+  const node_t& at(node_ind_t node_ind) const {
+    assert(node_ind != 0 && node_ind < nodes_.size());
+    return nodes_[node_ind];
+  }
+
+ private:
+  std::vector<node_t> nodes_ = {{}}; // 0 indexed is occupied by garbage
+};
+
+// ===========================   STRUCT OF ARRAYS   ===========================
+
+template <typename KeyT, typename NodeIndT>
+class AVL_node_storage_t<KeyT, NodeIndT, soa_storage_tag> {
+ public:
+  using node_ind_t    = NodeIndT;
+  using node_height_t = std::int8_t;
+
+ public:
+  // index -1 is reserved for end sentinel
+  static constexpr std::size_t max_size() {
+    return std::numeric_limits<node_ind_t>::max() - 1;
+  }
+
+  std::size_t size() const { return keys_.size(); }
+
+  // all arrays grow together, so they have the same capacity
+  std::size_t capacity() const { return keys_.capacity(); }
+
+  // bytes of memory, that single node slot takes in all arrays
+  static constexpr std::size_t node_bytes() {
+    return sizeof(KeyT) + sizeof(std::array<node_ind_t, 2>) + 2 * sizeof(node_ind_t) + sizeof(node_height_t);
+  }
+
+  void reserve(std::size_t capacity) {
+    keys_         .reserve(capacity);
+    sons_         .reserve(capacity);
+    subtree_sizes_.reserve(capacity);
+    parents_      .reserve(capacity);
+    heights_      .reserve(capacity);
+  }
+
+  void clear() {
+    keys_          = {{}};
+    sons_          = {{}};
+    subtree_sizes_ = {{}};
+    parents_       = {{}};
+    heights_       = {{}};
+  }
+
+  // hints cache to load fields of node, that are read by descent, null node is valid address too
+  void prefetch(node_ind_t node_ind) const {
+    __builtin_prefetch(keys_.data()          + node_ind);
+    __builtin_prefetch(sons_.data()          + node_ind);
+    __builtin_prefetch(subtree_sizes_.data() + node_ind);
+  }
+
+  // appends leaf node and returns its index
+  node_ind_t emplace_back(const KeyT& key) {
+    keys_.push_back(key);
+    sons_.push_back({});
+    subtree_sizes_.push_back(1);
+    parents_.push_back({});
+    heights_.push_back(1);
+    return static_cast<node_ind_t>(keys_.size() - 1);
+  }
+
+  void reset(node_ind_t node_ind, const KeyT& key) {
+    check_index(node_ind);
+    keys_[node_ind]          = key;
+    sons_[node_ind]          = {};
+    subtree_sizes_[node_ind] = 1;
+    parents_[node_ind]       = {};
+    heights_[node_ind]       = 1;
+  }
+
+  void reset(node_ind_t node_ind) {
+    reset(node_ind, KeyT{});
+    subtree_sizes_[node_ind] = 0;
+    heights_[node_ind]       = 0;
+  }
+
+        KeyT& key(node_ind_t node_ind)       { check_index(node_ind); return keys_[node_ind]; }
+  const KeyT& key(node_ind_t node_ind) const { check_index(node_ind); return keys_[node_ind]; }
+
+  node_ind_t& left  (node_ind_t node_ind)       { check_index(node_ind); return sons_[node_ind][0]; }
+  node_ind_t  left  (node_ind_t node_ind) const { check_index(node_ind); return sons_[node_ind][0]; }
+  node_ind_t& right (node_ind_t node_ind)       { check_index(node_ind); return sons_[node_ind][1]; }
+  node_ind_t  right (node_ind_t node_ind) const { check_index(node_ind); return sons_[node_ind][1]; }
+  node_ind_t  son   (node_ind_t node_ind, bool is_right) const {
+    check_index(node_ind);
+    return sons_[node_ind][is_right];
+  }
+  node_ind_t& parent(node_ind_t node_ind)       { check_index(node_ind); return parents_[node_ind]; }
+  node_ind_t  parent(node_ind_t node_ind) const { check_index(node_ind); return parents_[node_ind]; }
+
+  node_height_t height(node_ind_t node_ind) const {
+    check_index(node_ind);
+    return heights_[node_ind];
+  }
+
+  std::size_t subtree_size(node_ind_t node_ind) const {
+    check_index(node_ind);
+    return subtree_sizes_[node_ind];
+  }
+
+  void set_height(node_ind_t node_ind, node_height_t height) {
+    check_index(node_ind);
+    heights_[node_ind] = height;
+  }
+
+  void set_subtree_size(node_ind_t node_ind, std::size_t subtree_size) {
+    check_index(node_ind);
+    subtree_sizes_[node_ind] = static_cast<node_ind_t>(subtree_size);
+  }
+
+  void shift_subtree_size(node_ind_t node_ind, std::ptrdiff_t size_delta) {
+    check_index(node_ind);
+    subtree_sizes_[node_ind] += static_cast<node_ind_t>(size_delta);
+  }
+
+ private:
+  void check_index([[maybe_unused]] node_ind_t node_ind) const {
+    assert(node_ind != 0 && node_ind < keys_.size());
+  }
+
+ private:
+  // hot: read on every step of descent
+  std::vector<KeyT>                      keys_          = {{}};
+  std::vector<std::array<node_ind_t, 2>> sons_          = {{}}; // left and right sons share cache line
+  // warm: read by rank queries
+  std::vector<node_ind_t>                subtree_sizes_ = {{}};
+  // cold: touched only by rebalancing and iterators
+  std::vector<node_ind_t>                parents_       = {{}};
+  std::vector<node_height_t>             heights_       = {{}};
+};
@@ -0,0 +1,423 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// Persistent AVL tree: every update creates new version of tree, all previous versions stay
+// available. Update copies only nodes on the path from root to changed place (and sons
+// touched by rotations), so it appends O(log n) nodes to the arena, untouched subtrees
+// are shared between versions. Nodes, that were created by current update, are changed
+// in place, so single update never copies the same node twice.
+// Shared node has many parents, so nodes don't keep parent links like in AVL_tree_t,
+// iterators keep path from root instead.
+// Version 0 is empty tree, version i is tree after i-th update.
+template <typename KeyT = std::int64_t,
+          typename ComparatorT = std::less<KeyT>,
+          typename NodeIndT = std::size_t>
+class persistent_AVL_tree_t {
+  static_assert(std::is_unsigned_v<NodeIndT>, "node index type should be unsigned integer");
+
+ public:
+  using value_type = KeyT;
+  using key_type   = KeyT;
+
+ private:
+  using node_ind_t    = NodeIndT;
+  using node_height_t = std::int8_t;
+
+  // AVL tree of height 64 has more than 10^13 nodes
+  static constexpr std::size_t kMaxHeight = 64;
+
+ public:
+  // forward iterator over keys of one version. It keeps indices of nodes, so it stays valid
+  // after later updates of tree, but references and pointers to keys, that it returned, don't:
+  // updates may reallocate arena of nodes, like push_back() of std::vector
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = KeyT;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const KeyT*;
+    using reference         = const KeyT&;
+
+   public:
+    const_iterator() = default;
+
+    reference operator*() const {
+      assert(depth_ != 0);
+      return tree_->nodes_[path_[depth_ - 1]].key;
+    }
+
+    pointer operator->() const {
+      return &**this;
+    }
+
+    const_iterator& operator++() {
+      assert(depth_ != 0);
+      const node_ind_t right_ind = tree_->nodes_[path_[depth_ - 1]].right;
+      --depth_;
+      push_left_path(right_ind);
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator old_it = *this;
+      ++*this;
+      return old_it;
+    }
+
+    friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+      return lhs.depth_ == rhs.depth_ &&
+             (lhs.depth_ == 0 || lhs.path_[lhs.depth_ - 1] == rhs.path_[rhs.depth_ - 1]);
+    }
+
+    friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    friend class persistent_AVL_tree_t;
+
+    explicit const_iterator(const persistent_AVL_tree_t* tree)
+      : tree_(tree) {}
+
+    void push(node_ind_t node_ind) {
+      assert(depth_ < kMaxHeight);
+      path_[depth_++] = node_ind;
+    }
+
+    void push_left_path(node_ind_t node_ind) {
+      for (; node_ind != kNullNodeInd; node_ind = tree_->nodes_[node_ind].left) {
+        push(node_ind);
+      }
+    }
+
+   private:
+    const persistent_AVL_tree_t* tree_ = nullptr;
+    // ancestors, whose keys are not visited yet, current node is on top
+    std::array<node_ind_t, kMaxHeight> path_{};
+    std::size_t                        depth_{};
+  };
+
+  // read only view of one version, stays valid after later updates of tree
+  class version_t {
+   public:
+    std::size_t size() const { return tree_->nodes_[root_ind_].subtree_size; }
+
+    bool empty() const { return root_ind_ == kNullNodeInd; }
+
+    const_iterator begin() const {
+      const_iterator it(tree_);
+      it.push_left_path(root_ind_);
+      return it;
+    }
+
+    const_iterator end() const { return const_iterator(tree_); }
+
+    // first key, that is not less than key
+    const_iterator lower_bound(const KeyT& key) const {
+      return tree_->find_bound(root_ind_, key, false);
+    }
+
+    // first key, that is greater than key
+    const_iterator upper_bound(const KeyT& key) const {
+      return tree_->find_bound(root_ind_, key, true);
+    }
+
+    bool contains(const KeyT& key) const {
+      const_iterator it = lower_bound(key);
+      return it != end() && !tree_->comparator_(key, *it);
+    }
+
+    // number of keys, that are less than key
+    std::size_t count_less(const KeyT& key) const {
+      return tree_->count_keys_before(root_ind_, key, false);
+    }
+
+    // number of keys in [low_key, high_key]
+    std::size_t count_range(const KeyT& low_key, const KeyT& high_key) const {
+      if (tree_->comparator_(high_key, low_key)) {
+        return 0;
+      }
+
+      return tree_->count_keys_before(root_ind_, high_key, true) -
+             tree_->count_keys_before(root_ind_, low_key,  false);
+    }
+
+   private:
+    friend class persistent_AVL_tree_t;
+
+    version_t(const persistent_AVL_tree_t* tree, node_ind_t root_ind)
+      : tree_(tree), root_ind_(root_ind) {}
+
+   private:
+    const persistent_AVL_tree_t* tree_;
+    node_ind_t                   root_ind_;
+  };
+
+ public:
+  persistent_AVL_tree_t() = default;
+
+  // inserts key into the latest version, returns index of new version,
+  // new version is created even if key is already present, so that
+  // versions are numbered by updates
+  std::size_t insert(const KeyT& key) {
+    start_update();
+    return add_version(insert_into_subtree(roots_.back(), key));
+  }
+
+  // erases key from the latest version, returns index of new version
+  std::size_t erase(const KeyT& key) {
+    start_update();
+    return add_version(erase_from_subtree(roots_.back(), key));
+  }
+
+  version_t version(std::size_t version_ind) const {
+    if (version_ind >= roots_.size()) {
+      throw std::out_of_range("persistent_AVL_tree_t: there is no such version");
+    }
+
+    return version_t(this, roots_[version_ind]);
+  }
+
+  version_t latest() const { return version_t(this, roots_.back()); }
+
+  std::size_t latest_version_ind() const { return roots_.size() - 1; }
+
+  std::size_t versions_count() const { return roots_.size(); }
+
+  // nodes of all versions together (without null node), memory is proportional to it
+  std::size_t nodes_count() const { return nodes_.size() - 1; }
+
+  // index -1 is never used, subtree sizes have to fit into node index type too
+  static constexpr std::size_t max_nodes_count() {
+    return std::numeric_limits<node_ind_t>::max() - 1;
+  }
+
+  void reserve_nodes(std::size_t capacity) { nodes_.reserve(capacity + 1); }
+
+ private:
+  struct node_t {
+    KeyT          key{};
+    node_ind_t    left{};
+    node_ind_t    right{};
+    node_ind_t    subtree_size{};
+    node_height_t height{};
+  };
+
+  void start_update() {
+    first_new_node_ind_ = static_cast<node_ind_t>(nodes_.size());
+  }
+
+  std::size_t add_version(node_ind_t root_ind) {
+    roots_.push_back(root_ind);
+    return roots_.size() - 1;
+  }
+
+  node_ind_t append_node(const node_t& node) {
+    if (nodes_.size() > max_nodes_count()) {
+      throw std::length_error("persistent_AVL_tree_t: too many nodes for chosen node index type");
+    }
+
+    nodes_.push_back(node);
+    return static_cast<node_ind_t>(nodes_.size() - 1);
+  }
+
+  node_ind_t create_leaf(const KeyT& key) {
+    return append_node(node_t{key, kNullNodeInd, kNullNodeInd, 1, 1});
+  }
+
+  // copy of node, that may be changed, nodes of current update are changed in place
+  node_ind_t make_mutable(node_ind_t node_ind) {
+    if (node_ind >= first_new_node_ind_) {
+      return node_ind;
+    }
+
+    return append_node(node_t(nodes_[node_ind]));
+  }
+
+  // returns root of new subtree, that is the same node_ind if key is already present
+  node_ind_t insert_into_subtree(node_ind_t node_ind, const KeyT& key) {
+    if (node_ind == kNullNodeInd) {
+      return create_leaf(key);
+    }
+
+    const bool is_left = comparator_(key, nodes_[node_ind].key);
+    if (!is_left && !comparator_(nodes_[node_ind].key, key)) {
+      return node_ind;
+    }
+
+    const node_ind_t son_ind     = is_left ? nodes_[node_ind].left : nodes_[node_ind].right;
+    const node_ind_t new_son_ind = insert_into_subtree(son_ind, key);
+    if (new_son_ind == son_ind) {
+      return node_ind;
+    }
+
+    return replace_son(node_ind, is_left, new_son_ind);
+  }
+
+  // returns root of new subtree, that is the same node_ind if there is no such key
+  node_ind_t erase_from_subtree(node_ind_t node_ind, const KeyT& key) {
+    if (node_ind == kNullNodeInd) {
+      return kNullNodeInd;
+    }
+
+    const bool is_left  = comparator_(key, nodes_[node_ind].key);
+    const bool is_right = comparator_(nodes_[node_ind].key, key);
+    if (is_left || is_right) {
+      const node_ind_t son_ind     = is_left ? nodes_[node_ind].left : nodes_[node_ind].right;
+      const node_ind_t new_son_ind = erase_from_subtree(son_ind, key);
+      if (new_son_ind == son_ind) {
+        return node_ind;
+      }
+
+      return replace_son(node_ind, is_left, new_son_ind);
+    }
+
+    const node_ind_t left_ind  = nodes_[node_ind].left;
+    const node_ind_t right_ind = nodes_[node_ind].right;
+    if (left_ind == kNullNodeInd) {
+      return right_ind;
+    }
+    if (right_ind == kNullNodeInd) {
+      return left_ind;
+    }
+
+    // key of node is replaced by its successor, that is erased from right subtree
+    node_ind_t successor_ind = kNullNodeInd;
+    const node_ind_t new_right_ind = erase_min_from_subtree(right_ind, successor_ind);
+    const node_ind_t new_node_ind  = make_mutable(node_ind);
+    nodes_[new_node_ind].key   = nodes_[successor_ind].key;
+    nodes_[new_node_ind].right = new_right_ind;
+
+    return rebalance(new_node_ind);
+  }
+
+  node_ind_t erase_min_from_subtree(node_ind_t node_ind, node_ind_t& min_node_ind) {
+    const node_ind_t left_ind = nodes_[node_ind].left;
+    if (left_ind == kNullNodeInd) {
+      min_node_ind = node_ind;
+      return nodes_[node_ind].right;
+    }
+
+    return replace_son(node_ind, true, erase_min_from_subtree(left_ind, min_node_ind));
+  }
+
+  node_ind_t replace_son(node_ind_t node_ind, bool is_left, node_ind_t new_son_ind) {
+    const node_ind_t new_node_ind = make_mutable(node_ind);
+    if (is_left) {
+      nodes_[new_node_ind].left  = new_son_ind;
+    } else {
+      nodes_[new_node_ind].right = new_son_ind;
+    }
+
+    return rebalance(new_node_ind);
+  }
+
+  // node_ind has to be mutable, returns new root of subtree
+  node_ind_t rebalance(node_ind_t node_ind) {
+    recalc_node(node_ind);
+    const int balance = get_balance(node_ind);
+    if (balance > 1) {
+      if (get_balance(nodes_[node_ind].left) < 0) {
+        const node_ind_t left_ind = rotate_left(make_mutable(nodes_[node_ind].left));
+        nodes_[node_ind].left = left_ind;
+      }
+      return rotate_right(node_ind);
+    }
+    if (balance < -1) {
+      if (get_balance(nodes_[node_ind].right) > 0) {
+        const node_ind_t right_ind = rotate_right(make_mutable(nodes_[node_ind].right));
+        nodes_[node_ind].right = right_ind;
+      }
+      return rotate_left(node_ind);
+    }
+
+    return node_ind;
+  }
+
+  // node_ind has to be mutable, its left son becomes root of subtree
+  node_ind_t rotate_right(node_ind_t node_ind) {
+    const node_ind_t left_ind = make_mutable(nodes_[node_ind].left);
+    nodes_[node_ind].left  = nodes_[left_ind].right;
+    nodes_[left_ind].right = node_ind;
+    recalc_node(node_ind);
+    recalc_node(left_ind);
+
+    return left_ind;
+  }
+
+  // node_ind has to be mutable, its right son becomes root of subtree
+  node_ind_t rotate_left(node_ind_t node_ind) {
+    const node_ind_t right_ind = make_mutable(nodes_[node_ind].right);
+    nodes_[node_ind].right = nodes_[right_ind].left;
+    nodes_[right_ind].left = node_ind;
+    recalc_node(node_ind);
+    recalc_node(right_ind);
+
+    return right_ind;
+  }
+
+  void recalc_node(node_ind_t node_ind) {
+    node_t& node = nodes_[node_ind];
+    const node_t& left  = nodes_[node.left];
+    const node_t& right = nodes_[node.right];
+    node.height       = static_cast<node_height_t>(std::max(left.height, right.height) + 1);
+    node.subtree_size = left.subtree_size + right.subtree_size + 1;
+  }
+
+  int get_balance(node_ind_t node_ind) const {
+    return nodes_[nodes_[node_ind].left].height - nodes_[nodes_[node_ind].right].height;
+  }
+
+  std::size_t count_keys_before(node_ind_t node_ind, const KeyT& key, bool is_inclusive) const {
+    std::size_t count = 0;
+    while (node_ind != kNullNodeInd) {
+      const node_t& node = nodes_[node_ind];
+      const bool is_before = is_inclusive ? !comparator_(key, node.key) : comparator_(node.key, key);
+      if (is_before) {
+        count += nodes_[node.left].subtree_size + 1;
+        node_ind = node.right;
+      } else {
+        node_ind = node.left;
+      }
+    }
+
+    return count;
+  }
+
+  // first key, that is not less than key (is_strict = false) or greater than key (is_strict = true)
+  const_iterator find_bound(node_ind_t node_ind, const KeyT& key, bool is_strict) const {
+    const_iterator it(this);
+    while (node_ind != kNullNodeInd) {
+      const node_t& node = nodes_[node_ind];
+      const bool is_after = is_strict ? comparator_(key, node.key) : !comparator_(node.key, key);
+      if (is_after) {
+        it.push(node_ind);
+        node_ind = node.left;
+      } else {
+        node_ind = node.right;
+      }
+    }
+
+    return it;
+  }
+
+ private:
+  static constexpr node_ind_t kNullNodeInd = 0;
+
+ private:
+  std::vector<node_t>     nodes_ = {node_t{}}; // 0 indexed is null node with zero size and height
+  std::vector<node_ind_t> roots_ = {kNullNodeInd};
+  node_ind_t              first_new_node_ind_{};
+  ComparatorT             comparator_;
+};
@@ -1,27 +1,43 @@
 #pragma once
 
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "AVL_node_storage.hpp"
 #include "AVL_tree_fwd.hpp"
+#include "AVL_tree_stats.hpp"
 #include "logLib.hpp"
 
+// NodeIndT is unsigned type used for node indices and subtree sizes,
+// narrow types (e.g. std::uint32_t) make nodes much smaller, but limit capacity, see max_size()
+// StorageTagT selects memory layout of nodes, see AVL_node_storage.hpp
 template <typename KeyT = std::int64_t,
-          typename ComparatorT = std::less<KeyT>>
+          typename ComparatorT = std::less<KeyT>,
+          typename NodeIndT = std::size_t,
+          typename StorageTagT = aos_storage_tag>
 class AVL_tree_t {
+  static_assert(std::is_unsigned_v<NodeIndT>, "node index type should be unsigned integer");
+
  public:
   using value_type = KeyT;
   using   key_type = KeyT;
   static const std::size_t size_type = sizeof(KeyT);
 
  private:
-  class node_t; // forward declaration of class node_t
-  using node_ind_t = std::size_t;
+  using node_storage_t = AVL_node_storage_t<KeyT, NodeIndT, StorageTagT>;
+  using node_ind_t     = NodeIndT;
+  using node_height_t  = typename node_storage_t::node_height_t;
 
  public:
   template <typename Ref>
@@ -55,6 +71,15 @@ class AVL_tree_t {
 
     std::size_t operator-(const AVL_tree_iterator& other) const;
 
+    // jumps by offset keys using subtree sizes, O(log n)
+    AVL_tree_iterator& operator+=(std::ptrdiff_t offset);
+
+    AVL_tree_iterator& operator-=(std::ptrdiff_t offset);
+
+    AVL_tree_iterator operator+(std::ptrdiff_t offset) const;
+
+    AVL_tree_iterator operator-(std::ptrdiff_t offset) const;
+
     Ref operator*();
 
     bool operator==(const AVL_tree_iterator& other) const;
@@ -84,12 +109,14 @@ class AVL_tree_t {
       "Error: operator()-- called on .begin() iterator...";
     const std::string_view kIteratorAfterEndErrMsg =
       "Error: operator()++ called on .end() iterator...";
+    const std::string_view kIteratorJumpOutOfRangeErrMsg =
+      "Error: iterator jump leaves [begin(), end()] range...";
 
    private:
     TreeRef tree_;
     node_ind_t cur_node_ind_;
-    // const auto get_left_node_  = [tree_](node_ind_t node_ind){ return tree_.get_node(node_ind).left; };
-    // const auto get_right_node_ = [tree_](node_ind_t node_ind){ return tree_.get_node(node_ind).right; };
+    // const auto get_left_node_  = [tree_](node_ind_t node_ind){ return tree_.nodes_buffer_.left(node_ind); };
+    // const auto get_right_node_ = [tree_](node_ind_t node_ind){ return tree_.nodes_buffer_.right(node_ind); };
   };
 
  public:
@@ -97,10 +124,66 @@ class AVL_tree_t {
 
   AVL_tree_t(const std::initializer_list<KeyT>& init_list);
 
+  // builds perfectly balanced tree in O(n) after sorting and removing duplicates
+  template <typename InputIt,
+            typename = typename std::iterator_traits<InputIt>::iterator_category>
+  AVL_tree_t(InputIt first, InputIt last);
+
+  // replaces content with keys from range, that is already sorted by comparator,
+  // equal neighbouring keys are skipped, O(n)
+  template <typename InputIt>
+  void assign_sorted(InputIt first, InputIt last);
+
   void clear();
 
   void insert(const KeyT& new_key);
 
+  // Inserts all keys from range. Batch is copied, sorted and deduplicated, then goes through
+  // insert_sorted_batch(), single key goes straight to insert().
+  template <typename InputIt>
+  void insert_batch(InputIt first, InputIt last);
+
+  // Inserts keys from range, that is sorted by comparator and has no equal keys. Batch is either
+  // merged with content of tree and rebuilt in O(n + m) (large batch, invalidates iterators),
+  // or inserted in sorted order, where each descent starts from the node of previous key.
+  template <typename ForwardIt>
+  void insert_sorted_batch(ForwardIt first, ForwardIt last);
+
+  // returns number of erased keys (0 or 1)
+  std::size_t erase(const KeyT& key);
+
+  // returns iterator to the key after erased one
+  iterator erase(iterator pos);
+
+  // All keys of left are less than pivot, all keys of right are greater. Smaller tree is
+  // relocated into arena of larger one, then they are joined in O(|height difference| + 1).
+  // Both trees are left empty.
+  static AVL_tree_t join(AVL_tree_t&& left, const KeyT& pivot, AVL_tree_t&& right);
+
+  // Keys that are not less than key are moved into returned tree, the rest stay.
+  // O(log n) joins plus relocation of the smaller part into new arena. Invalidates iterators.
+  AVL_tree_t split(const KeyT& key);
+
+  // Moves all keys of other into this tree, other is left empty. Trees with disjoint
+  // key ranges are joined as in join(), otherwise keys of other go through insert_batch().
+  void merge(AVL_tree_t&& other);
+
+  std::size_t size() const;
+
+  bool empty() const;
+
+  // number of nodes on the longest path from root, i.e. max number of nodes visited by search
+  std::size_t height() const;
+
+  // max number of keys, that fit into NodeIndT with chosen storage
+  static constexpr std::size_t max_size();
+
+  // comparator, that orders keys of tree, like std::set::key_comp()
+  ComparatorT key_comp() const;
+
+  // depth histogram, memory of node arena and update counters (with AVL_COUNTERS_), O(n)
+  AVL_tree_stats_t stats() const;
+
   const_iterator begin() const;
 
   iterator begin();
@@ -121,6 +204,31 @@ class AVL_tree_t {
 
   const_iterator upper_bound(KeyT key) const;
 
+  // iterator to k-th smallest key (0-indexed), end() if k >= size()
+  iterator select(std::size_t k);
+
+  const_iterator select(std::size_t k) const;
+
+  // same as select(k), named after std::nth_element
+  iterator nth_element(std::size_t k);
+
+  const_iterator nth_element(std::size_t k) const;
+
+  // number of keys that are less than key
+  std::size_t count_less(const KeyT& key) const;
+
+  // number of keys in [low_key, high_key], single top-down descent
+  std::size_t count_range(const KeyT& low_key, const KeyT& high_key) const;
+
+  // ================ batched search, see AVL_tree_batch_search.hpp ===========
+  // writes lower_bound(key) for every key of [first, last) into out
+  template <typename InputIt, typename OutputIt>
+  void lower_bound_batch(InputIt first, InputIt last, OutputIt out) const;
+
+  // writes count_range(low_key, high_key) for every pair of [first, last) into out
+  template <typename InputIt, typename OutputIt>
+  void count_range_batch(InputIt first, InputIt last, OutputIt out) const;
+
   // ================ visualization method ===========
 #ifdef DEBUG_
   void visualize_tree(
@@ -129,12 +237,38 @@ class AVL_tree_t {
 #endif
 
  private:
-  using node_height_t = std::int8_t;
 
   [[nodiscard]] node_ind_t get_new_node(const KeyT& key);
 
-  [[nodiscard]] node_ind_t add_new_key_recursively(
-    node_ind_t cur_node, const KeyT& new_key
+  void build_from_sorted_unique(const std::vector<KeyT>& keys);
+
+  void free_node(node_ind_t node_ind);
+
+  // increments counter in counters mode (AVL_COUNTERS_), compiled away otherwise
+  void count_event([[maybe_unused]] std::size_t AVL_operation_counters_t::* counter);
+
+  void erase_node(node_ind_t node_ind);
+
+  node_ind_t join_subtrees(node_ind_t left_root_ind, node_ind_t pivot_ind, node_ind_t right_root_ind);
+
+  node_ind_t join_subtrees(node_ind_t left_root_ind, node_ind_t right_root_ind);
+
+  std::pair<node_ind_t, node_ind_t> split_subtree(node_ind_t subtree_root_ind, const KeyT& key);
+
+  node_ind_t copy_subtree_from(const AVL_tree_t& other, node_ind_t other_node_ind);
+
+  void free_subtree(node_ind_t subtree_root_ind);
+
+  node_ind_t insert_into_subtree(node_ind_t start_node_ind, const KeyT& new_key);
+
+  [[nodiscard]] node_ind_t find_subtree_for_next_key(
+    node_ind_t prev_node_ind, const KeyT& next_key
+  ) const;
+
+  void retrace(node_ind_t node_ind, std::ptrdiff_t size_delta);
+
+  void replace_son(
+    node_ind_t parent_ind, node_ind_t old_kid_ind, node_ind_t new_kid_ind
   );
 
   [[nodiscard]] node_ind_t rotate_node_right(node_ind_t node_ind);
@@ -155,14 +289,21 @@ class AVL_tree_t {
 
   void set_node_left_son (node_ind_t parent_ind, node_ind_t kid_ind);
 
-  [[nodiscard]] node_t& get_node(node_ind_t node_ind);
-
-  [[nodiscard]] const node_t& get_node(node_ind_t node_ind) const;
-
   [[nodiscard]] node_ind_t general_find_node_after_key(
     KeyT key, bool skip_equal
   ) const;
 
+  // one level of descent of general_find_node_after_key(), returns next node
+  [[nodiscard]] node_ind_t find_node_after_key_step(
+    node_ind_t cur_node_ind, const KeyT& key, bool skip_equal, node_ind_t& candidate_ind
+  ) const;
+
+  [[nodiscard]] node_ind_t select_node(std::size_t k) const;
+
+  [[nodiscard]] std::size_t count_keys_before(
+    node_ind_t subtree_root_ind, const KeyT& key, bool include_equal
+  ) const;
+
   // ================ visualization methods ===========
 #ifdef DEBUG_
   void generate_dot(const std::string dot_filename) const;
@@ -187,89 +328,285 @@ class AVL_tree_t {
 #endif
 
  private:
-  static const node_ind_t kNullNodeInd = 0;
-  static const node_ind_t kEndSentinel = static_cast<node_ind_t>(-1);
+  static constexpr node_ind_t kNullNodeInd = 0;
+  static constexpr node_ind_t kEndSentinel = static_cast<node_ind_t>(-1);
   // static const node_ind_t kEndSentinel = -
 
- private:
-  class node_t {
-   public:
-    KeyT          key{};
-    node_ind_t    left{};
-    node_ind_t    right{};
-    node_ind_t    parent{};
-    node_height_t height{};
-    std::size_t   subtree_size{};
-
-    node_t() = default;
-    node_t(const KeyT& key)
-      : key(key), left(kNullNodeInd), right(kNullNodeInd),
-        parent(kNullNodeInd), height(1), subtree_size(1) {}
-  };
+  // numbers compared with std::less: descent compares keys once per level and selects son
+  // and candidate by index and mask, so there are no branches, that depend on keys
+  static constexpr bool kIsBranchFreeSearch =
+    std::is_arithmetic_v<KeyT> &&
+    (std::is_same_v<ComparatorT, std::less<KeyT>> || std::is_same_v<ComparatorT, std::less<>>);
 
+  // batch with at least size() / kRebuildBatchDivisor keys is merged and rebuilt
+  static const std::size_t kRebuildBatchDivisor = 4;
+
+  // number of descents, that are interleaved by batched search
+  static constexpr std::size_t kSearchGroupSize = 16;
+
+ private:
   ComparatorT         comparator_;
   node_ind_t          root_node_ind_ = kNullNodeInd;
-  std::vector<node_t> nodes_buffer_ = {{}}; // 0 indexed is occupied by garbage, so nodes have indices >= 1
+  node_storage_t      nodes_buffer_; // 0 indexed is occupied by garbage, so nodes have indices >= 1
+  node_ind_t          free_list_head_ = kNullNodeInd; // erased slots, linked through left son
+#ifdef AVL_COUNTERS_
+  AVL_operation_counters_t counters_;
+#endif
 };
 
-template <typename KeyT, typename ComparatorT>
-AVL_tree_t<KeyT, ComparatorT>::AVL_tree_t(const std::initializer_list<KeyT>& init_list) {
-  std::size_t iter_num = 1;
-  for (auto it = init_list.begin(); it != init_list.end(); ++it) {
-    insert(*it);
-#ifdef DEBUG_
-    // visualize_tree("avl_tree_vizualized" + std::to_string(iter_num++));
-#endif
-  }
-}
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::AVL_tree_t(const std::initializer_list<KeyT>& init_list)
+  : AVL_tree_t(init_list.begin(), init_list.end()) {}
 
-template <typename KeyT, typename ComparatorT>
-void AVL_tree_t<KeyT, ComparatorT>::insert(const KeyT& new_key) {
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::insert(const KeyT& new_key) {
 #if 0
   LOG_DEBUG_VARS((size_t)new_key);
 #endif
-  root_node_ind_ = add_new_key_recursively(root_node_ind_, new_key);
+  if (root_node_ind_ == kNullNodeInd) {
+    count_event(&AVL_operation_counters_t::inserted_nodes);
+    root_node_ind_ = get_new_node(new_key);
+    return;
+  }
+
+  insert_into_subtree(root_node_ind_, new_key);
+}
+
+// Inserts key into subtree of start_node_ind, caller guarantees that key belongs to it.
+// Returns index of node with new_key (either new or already existing one).
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::insert_into_subtree(
+  node_ind_t start_node_ind, const KeyT& new_key
+) -> node_ind_t {
+  // single descent, parent of new leaf is the last visited node
+  node_ind_t parent_ind = start_node_ind;
+  bool is_right_son = false;
+  while (true) {
+    const KeyT& cur_key = nodes_buffer_.key(parent_ind);
+    is_right_son = comparator_(cur_key, new_key);
+    if (!is_right_son && !comparator_(new_key, cur_key)) {
+      // new_key has already been inserted before
+      LOG_DEBUG_VARS((size_t)new_key, "duplicate");
+      return parent_ind;
+    }
+
+    node_ind_t next_node_ind = is_right_son ? nodes_buffer_.right(parent_ind)
+                                            : nodes_buffer_.left(parent_ind);
+    if (next_node_ind == kNullNodeInd) {
+      break;
+    }
+    parent_ind = next_node_ind;
+  }
+
+  // WARNING: get_new_node() may reallocate nodes_buffer_, so no references are kept across it
+  count_event(&AVL_operation_counters_t::inserted_nodes);
+  node_ind_t new_node_ind = get_new_node(new_key);
+  if (is_right_son) {
+    nodes_buffer_.right(parent_ind) = new_node_ind;
+  } else {
+    nodes_buffer_.left(parent_ind)  = new_node_ind;
+  }
+  nodes_buffer_.parent(new_node_ind) = parent_ind;
+
+  retrace(parent_ind, +1);
   // LOG_DEBUG_VARS(root_node_ind_);
+  return new_node_ind;
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+std::size_t AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::erase(const KeyT& key) {
+  node_ind_t node_ind = general_find_node_after_key(key, false);
+  if (node_ind == kEndSentinel || comparator_(key, nodes_buffer_.key(node_ind))) {
+    return 0; // there is no such key
+  }
+
+  erase_node(node_ind);
+  return 1;
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::erase(iterator pos) -> iterator {
+  assert(pos != end());
+
+  iterator next_pos = pos;
+  ++next_pos;
+  // nodes are relinked, not moved, so next_pos stays valid
+  erase_node(pos.cur_node_ind_);
+  return next_pos;
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+std::size_t AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::size() const {
+  return get_node_subtree_size(root_node_ind_);
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+bool AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::empty() const {
+  return root_node_ind_ == kNullNodeInd;
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+std::size_t AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::height() const {
+  return get_node_height(root_node_ind_);
 }
 
-template <typename KeyT, typename ComparatorT>
-void AVL_tree_t<KeyT, ComparatorT>::clear() {
-  nodes_buffer_ = {{}};
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+AVL_tree_stats_t AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::stats() const {
+  AVL_tree_stats_t stats;
+  stats.size   = size();
+  stats.height = height();
+
+  stats.depth_histogram.assign(stats.height, 0);
+  std::size_t depths_sum = 0;
+  std::vector<std::pair<node_ind_t, std::size_t>> nodes_stack; // node and its depth
+  if (root_node_ind_ != kNullNodeInd) {
+    nodes_stack.emplace_back(root_node_ind_, 0);
+  }
+  while (!nodes_stack.empty()) {
+    const auto [node_ind, depth] = nodes_stack.back();
+    nodes_stack.pop_back();
+    ++stats.depth_histogram[depth];
+    depths_sum += depth;
+
+    for (bool is_right : {false, true}) {
+      const node_ind_t son_ind = nodes_buffer_.son(node_ind, is_right);
+      if (son_ind != kNullNodeInd) {
+        nodes_stack.emplace_back(son_ind, depth + 1);
+      }
+    }
+  }
+  stats.average_search_depth = stats.size != 0
+    ? static_cast<double>(depths_sum + stats.size) / stats.size
+    : 0.0;
+
+  stats.nodes_count    = nodes_buffer_.size();
+  stats.free_nodes     = stats.nodes_count - 1 - stats.size;
+  stats.nodes_capacity = nodes_buffer_.capacity();
+  stats.node_bytes     = node_storage_t::node_bytes();
+  stats.memory_bytes   = stats.nodes_capacity * stats.node_bytes;
+  stats.bytes_per_key  = stats.size != 0 ? static_cast<double>(stats.memory_bytes) / stats.size : 0.0;
+
+#ifdef AVL_COUNTERS_
+  stats.are_counters_enabled = true;
+  stats.counters = counters_;
+#endif
+
+  return stats;
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+constexpr std::size_t AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::max_size() {
+  return node_storage_t::max_size();
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+ComparatorT AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::key_comp() const {
+  return comparator_;
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::clear() {
+  nodes_buffer_.clear();
+  free_list_head_ = kNullNodeInd;
   root_node_ind_ = kNullNodeInd;
 }
 
 // ======================   private methods   ========================
 
-template <typename KeyT, typename ComparatorT>
-auto AVL_tree_t<KeyT, ComparatorT>::add_new_key_recursively(
-  node_ind_t cur_node_ind, const KeyT& new_key
-) -> node_ind_t {
-  if (cur_node_ind == kNullNodeInd) {
-    node_ind_t new_node_ind = get_new_node(new_key);
-    return new_node_ind;
+// Goes up from node_ind to the root, restoring heights and balance.
+// As soon as height of a subtree is the same as before update, nodes above
+// can't become unbalanced, so only their subtree sizes are shifted by size_delta.
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::retrace(
+  node_ind_t node_ind, std::ptrdiff_t size_delta
+) {
+  while (node_ind != kNullNodeInd) {
+    node_height_t old_height = nodes_buffer_.height(node_ind);
+    node_ind_t    parent_ind = nodes_buffer_.parent(node_ind);
+
+    recalc_node_height_and_size(node_ind);
+    node_ind_t new_subtree_root = balance_node(node_ind);
+    if (new_subtree_root != node_ind) {
+      replace_son(parent_ind, node_ind, new_subtree_root);
+    }
+
+    node_ind = parent_ind;
+    if (nodes_buffer_.height(new_subtree_root) == old_height) {
+      break;
+    }
   }
 
-  node_t& cur_node = nodes_buffer_[cur_node_ind];
-  if (comparator_(cur_node.key, new_key)) {
-    node_ind_t new_right_son = add_new_key_recursively(cur_node.right, new_key);
-    set_node_right_son(cur_node_ind, new_right_son);
-  } else if (comparator_(new_key, cur_node.key)) {
-    node_ind_t new_left_son  = add_new_key_recursively(cur_node.left,  new_key);
-    set_node_left_son(cur_node_ind, new_left_son);
-  } else { // new_key has already been inserted before
-    LOG_DEBUG_VARS((size_t)new_key, "duplicate");
-    return cur_node_ind;
+  for (; node_ind != kNullNodeInd; node_ind = nodes_buffer_.parent(node_ind)) {
+    nodes_buffer_.shift_subtree_size(node_ind, size_delta);
   }
-#if 0
-  LOG_DEBUG_VARS(cur_node_ind, cur_node.left, cur_node.right);
-#endif
+}
 
-  cur_node_ind = balance_node(cur_node_ind);
-  return cur_node_ind;
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::erase_node(node_ind_t node_ind) {
+  const node_ind_t left_ind   = nodes_buffer_.left(node_ind);
+  const node_ind_t right_ind  = nodes_buffer_.right(node_ind);
+  const node_ind_t parent_ind = nodes_buffer_.parent(node_ind);
+  node_ind_t retrace_start_ind = kNullNodeInd;
+
+  if (left_ind == kNullNodeInd || right_ind == kNullNodeInd) {
+    // at most one son, it simply takes place of erased node
+    node_ind_t kid_ind = left_ind != kNullNodeInd ? left_ind : right_ind;
+    retrace_start_ind = parent_ind;
+    replace_son(parent_ind, node_ind, kid_ind);
+  } else {
+    // successor node (it has no left son) is moved to the place of erased node
+    node_ind_t successor_ind = right_ind;
+    while (nodes_buffer_.left(successor_ind) != kNullNodeInd) {
+      successor_ind = nodes_buffer_.left(successor_ind);
+    }
+
+    if (nodes_buffer_.parent(successor_ind) == node_ind) {
+      retrace_start_ind = successor_ind;
+    } else {
+      retrace_start_ind = nodes_buffer_.parent(successor_ind);
+      replace_son(retrace_start_ind, successor_ind, nodes_buffer_.right(successor_ind));
+      nodes_buffer_.right(successor_ind) = right_ind;
+      nodes_buffer_.parent(right_ind) = successor_ind;
+    }
+    nodes_buffer_.left(successor_ind) = left_ind;
+    nodes_buffer_.parent(left_ind) = successor_ind;
+
+    // successor inherits old metadata, so retrace sees real change of subtree height
+    nodes_buffer_.set_height      (successor_ind, nodes_buffer_.height(node_ind));
+    nodes_buffer_.set_subtree_size(successor_ind, nodes_buffer_.subtree_size(node_ind));
+    replace_son(parent_ind, node_ind, successor_ind);
+  }
+
+  free_node(node_ind);
+  retrace(retrace_start_ind, -1);
 }
 
-template <typename KeyT, typename ComparatorT>
-[[nodiscard]] auto AVL_tree_t<KeyT, ComparatorT>::balance_node(
+// makes new_kid_ind son of parent_ind instead of old_kid_ind (or new root, if there is no parent)
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::replace_son(
+  node_ind_t parent_ind,
+  node_ind_t old_kid_ind,
+  node_ind_t new_kid_ind
+) {
+  if (new_kid_ind != kNullNodeInd) {
+    nodes_buffer_.parent(new_kid_ind) = parent_ind;
+  }
+
+  if (parent_ind == kNullNodeInd) {
+    root_node_ind_ = new_kid_ind;
+    return;
+  }
+
+  if (nodes_buffer_.left(parent_ind) == old_kid_ind) {
+    nodes_buffer_.left(parent_ind)  = new_kid_ind;
+  } else {
+    assert(nodes_buffer_.right(parent_ind) == old_kid_ind);
+    nodes_buffer_.right(parent_ind) = new_kid_ind;
+  }
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+[[nodiscard]] auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::balance_node(
   node_ind_t node_ind
 ) -> node_ind_t {
   if (node_ind == kNullNodeInd) {
@@ -279,20 +616,22 @@ template <typename KeyT, typename ComparatorT>
   node_height_t balance = get_node_balance(node_ind);
 #if 0
   LOG_DEBUG_VARS(balance, node_ind, 
-    get_node_height(get_node(node_ind).left), get_node_height(get_node(node_ind).right));
+    get_node_height(nodes_buffer_.left(node_ind)), get_node_height(nodes_buffer_.right(node_ind)));
 #endif
   if (std::abs(balance) <= 1) { // node is already balanced
     return node_ind;
   }
+  count_event(&AVL_operation_counters_t::rebalances);
 
-  node_t& node = get_node(node_ind);
+  const node_ind_t left_ind  = nodes_buffer_.left(node_ind);
+  const node_ind_t right_ind = nodes_buffer_.right(node_ind);
 #if 0
-  LOG_DEBUG_VARS("balancing", balance, node_ind, node.left, node.right);
+  LOG_DEBUG_VARS("balancing", balance, node_ind, left_ind, right_ind);
 #endif
   if (balance == 2) {
-    node_height_t right_node_balance = get_node_balance(node.right);
+    node_height_t right_node_balance = get_node_balance(right_ind);
     if (right_node_balance < 0) {
-      node_ind_t new_right = rotate_node_right(node.right);
+      node_ind_t new_right = rotate_node_right(right_ind);
       set_node_right_son(node_ind, new_right);
     }
 
@@ -307,27 +646,27 @@ template <typename KeyT, typename ComparatorT>
   }
 #endif
   assert(balance == -2);
-  node_height_t left_node_balance = get_node_balance(node.left);
+  node_height_t left_node_balance = get_node_balance(left_ind);
   if (left_node_balance > 0) {
-    node_ind_t new_left = rotate_node_left(node.left);
+    node_ind_t new_left = rotate_node_left(left_ind);
     set_node_left_son(node_ind, new_left);
   }
 
   return rotate_node_right(node_ind);
 }
 
-template <typename KeyT, typename ComparatorT>
-auto AVL_tree_t<KeyT, ComparatorT>::rotate_node_right(
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::rotate_node_right(
   node_ind_t cur_node_ind
 ) -> node_ind_t {
   if (cur_node_ind == kNullNodeInd) {
     return kNullNodeInd;
   }
-  node_t& cur_node = get_node(cur_node_ind);
-  assert(cur_node.left != kNullNodeInd);
+  assert(nodes_buffer_.left(cur_node_ind) != kNullNodeInd);
+  count_event(&AVL_operation_counters_t::right_rotations);
 
-  const node_ind_t kNewSubtreeRootInd = cur_node.left;
-  node_ind_t new_root_right_son = get_node(kNewSubtreeRootInd).right;
+  const node_ind_t kNewSubtreeRootInd = nodes_buffer_.left(cur_node_ind);
+  node_ind_t new_root_right_son = nodes_buffer_.right(kNewSubtreeRootInd);
 
   set_node_left_son(cur_node_ind, new_root_right_son);
   set_node_right_son(kNewSubtreeRootInd, cur_node_ind);
@@ -335,18 +674,18 @@ auto AVL_tree_t<KeyT, ComparatorT>::rotate_node_right(
   return kNewSubtreeRootInd;
 }
 
-template <typename KeyT, typename ComparatorT>
-auto AVL_tree_t<KeyT, ComparatorT>::rotate_node_left(
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::rotate_node_left(
   node_ind_t cur_node_ind
 ) -> node_ind_t {
   if (cur_node_ind == kNullNodeInd) {
     return kNullNodeInd;
   }
-  node_t& cur_node = get_node(cur_node_ind);
-  assert(cur_node.right != kNullNodeInd);
+  assert(nodes_buffer_.right(cur_node_ind) != kNullNodeInd);
+  count_event(&AVL_operation_counters_t::left_rotations);
 
-  const node_ind_t kNewSubtreeRootInd = cur_node.right;
-  node_ind_t new_root_left_son = get_node(kNewSubtreeRootInd).left;
+  const node_ind_t kNewSubtreeRootInd = nodes_buffer_.right(cur_node_ind);
+  node_ind_t new_root_left_son = nodes_buffer_.left(kNewSubtreeRootInd);
 
 #if 0
   // LOG_DEBUG_VARS(kNewSubtreeRootInd, new_root_left_son);
@@ -358,101 +697,123 @@ auto AVL_tree_t<KeyT, ComparatorT>::rotate_node_left(
   return kNewSubtreeRootInd;
 }
 
-template <typename KeyT, typename ComparatorT>
-void AVL_tree_t<KeyT, ComparatorT>::recalc_node_height_and_size(node_ind_t node_ind) {
-  node_t& cur_node = get_node(node_ind);
-  node_height_t  left_height     = get_node_height(cur_node.left);
-  node_height_t right_height     = get_node_height(cur_node.right);
-  std::size_t  left_subtree_size = get_node_subtree_size(cur_node.left);
-  std::size_t right_subtree_size = get_node_subtree_size(cur_node.right);
-
-  cur_node.height = std::max(left_height, right_height) + 1;
-  cur_node.subtree_size = left_subtree_size + 1 + right_subtree_size;
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::recalc_node_height_and_size(node_ind_t node_ind) {
+  const node_ind_t left_ind  = nodes_buffer_.left(node_ind);
+  const node_ind_t right_ind = nodes_buffer_.right(node_ind);
+  node_height_t  left_height     = get_node_height(left_ind);
+  node_height_t right_height     = get_node_height(right_ind);
+  std::size_t  left_subtree_size = get_node_subtree_size(left_ind);
+  std::size_t right_subtree_size = get_node_subtree_size(right_ind);
+
+  nodes_buffer_.set_height(node_ind, std::max(left_height, right_height) + 1);
+  nodes_buffer_.set_subtree_size(node_ind, left_subtree_size + 1 + right_subtree_size);
 }
 
-template <typename KeyT, typename ComparatorT>
-[[nodiscard]] auto AVL_tree_t<KeyT, ComparatorT>::get_node_balance(
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+[[nodiscard]] auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::get_node_balance(
   node_ind_t node_ind
 ) const -> node_height_t {
-  const node_t& cur_node = get_node(node_ind);
-  return get_node_height(cur_node.right) -
-         get_node_height(cur_node.left);
+  return get_node_height(nodes_buffer_.right(node_ind)) -
+         get_node_height(nodes_buffer_.left(node_ind));
 }
 
-template <typename KeyT, typename ComparatorT>
-[[nodiscard]] typename AVL_tree_t<KeyT, ComparatorT>::node_height_t
-AVL_tree_t<KeyT, ComparatorT>::get_node_height(node_ind_t node_ind) const {
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+[[nodiscard]] typename AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::node_height_t
+AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::get_node_height(node_ind_t node_ind) const {
   return node_ind != kNullNodeInd
-            ? get_node(node_ind).height
+            ? nodes_buffer_.height(node_ind)
             : 0;
 }
 
-template <typename KeyT, typename ComparatorT>
-[[nodiscard]] std::size_t AVL_tree_t<KeyT, ComparatorT>::
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+[[nodiscard]] std::size_t AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::
 get_node_subtree_size(node_ind_t node_ind) const {
   return node_ind != kNullNodeInd
-            ? get_node(node_ind).subtree_size
+            ? nodes_buffer_.subtree_size(node_ind)
             : 0;
 }
 
-template <typename KeyT, typename ComparatorT>
-void AVL_tree_t<KeyT, ComparatorT>::set_node_right_son(
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::set_node_right_son(
   node_ind_t parent_ind,
   node_ind_t kid_ind
 ) {
-  get_node(parent_ind).right = kid_ind;
-  // WARNING: do it work?
-  get_node(parent_ind).parent = kNullNodeInd;
+  nodes_buffer_.right(parent_ind) = kid_ind;
   if (kid_ind != kNullNodeInd) {
-    get_node(kid_ind).parent = parent_ind;
+    nodes_buffer_.parent(kid_ind) = parent_ind;
   }
 
   recalc_node_height_and_size(parent_ind);
 }
 
 // ASK: copypaste?
-template <typename KeyT, typename ComparatorT>
-void AVL_tree_t<KeyT, ComparatorT>::set_node_left_son(
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::set_node_left_son(
   node_ind_t parent_ind,
   node_ind_t kid_ind
 ) {
-  get_node(parent_ind).left = kid_ind;
-  // WARNING: do it work?
-  get_node(parent_ind).parent = kNullNodeInd;
+  nodes_buffer_.left(parent_ind) = kid_ind;
   if (kid_ind != kNullNodeInd) {
-    get_node(kid_ind).parent = parent_ind;
+    nodes_buffer_.parent(kid_ind) = parent_ind;
   }
 
   recalc_node_height_and_size(parent_ind);
 }
 
-// ASK: ok? How not to write this every time: AVL_tree_t<KeyT, ComparatorT>?
-template <typename KeyT, typename ComparatorT>
-auto AVL_tree_t<KeyT, ComparatorT>::get_node(node_ind_t node_ind) -> node_t& {
-  assert(node_ind != kNullNodeInd);
-  assert(node_ind != kEndSentinel);
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::get_new_node(
+  const KeyT& key
+) -> node_ind_t {
+  if (free_list_head_ != kNullNodeInd) {
+    // reuse slot of previously erased node
+    node_ind_t node_ind = free_list_head_;
+    free_list_head_ = nodes_buffer_.left(node_ind);
+    nodes_buffer_.reset(node_ind, key);
+    return node_ind;
+  }
 
-  return nodes_buffer_[node_ind];
-}
+  if (nodes_buffer_.size() > max_size()) {
+    // index or subtree size would silently overflow NodeIndT
+    throw std::length_error("AVL_tree_t: too many keys for chosen node index type, at most " +
+                            std::to_string(max_size()) + " keys fit");
+  }
 
-template <typename KeyT, typename ComparatorT>
-auto AVL_tree_t<KeyT, ComparatorT>::get_node(node_ind_t node_ind) const -> const node_t& {
-  assert(node_ind != kNullNodeInd);
+  return nodes_buffer_.emplace_back(key);
+}
 
-  return nodes_buffer_[node_ind];
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::free_node(node_ind_t node_ind) {
+  count_event(&AVL_operation_counters_t::freed_nodes);
+  // resets key too, so that resources of non trivial keys are released
+  nodes_buffer_.reset(node_ind);
+  nodes_buffer_.left(node_ind) = free_list_head_;
+  free_list_head_ = node_ind;
 }
 
-template <typename KeyT, typename ComparatorT>
-auto AVL_tree_t<KeyT, ComparatorT>::get_new_node(
-  const KeyT& key
-) -> node_ind_t {
-  nodes_buffer_.emplace_back(key);
-  return nodes_buffer_.size() - 1;
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::count_event(
+  [[maybe_unused]] std::size_t AVL_operation_counters_t::* counter
+) {
+#ifdef AVL_COUNTERS_
+  ++(counters_.*counter);
+#endif
 }
 
+// 32-bit indices: int keyed node takes 20 bytes instead of 48, capacity is 2^26 - 2 keys
+template <typename KeyT, typename ComparatorT = std::less<KeyT>>
+using compact_AVL_tree_t = AVL_tree_t<KeyT, ComparatorT, std::uint32_t>;
+
+// 32-bit indices, nodes are split into hot (key, sons) and cold (size, height, parent) arrays
+template <typename KeyT, typename ComparatorT = std::less<KeyT>>
+using soa_AVL_tree_t = AVL_tree_t<KeyT, ComparatorT, std::uint32_t, soa_storage_tag>;
+
 #ifdef DEBUG_
 #include "AVL_vizualization.hpp"
 #endif
 
 #include "AVL_iterator.hpp"
+#include "AVL_tree_batch_search.hpp"
+#include "AVL_tree_bulk_build.hpp"
+#include "AVL_tree_join_split.hpp"
 #include "AVL_tree_lower_upper_bound.hpp"
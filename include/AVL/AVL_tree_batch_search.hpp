@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "AVL_tree_fwd.hpp"
+
+// Batched search: descents of up to kSearchGroupSize independent queries are advanced in
+// lockstep. Every round makes one step of each unfinished descent and prefetches node of its
+// next step, so cache misses of different descents overlap instead of stalling one by one.
+// Results are the same as of separate calls in the same order.
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+template <typename InputIt, typename OutputIt>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::lower_bound_batch(
+  InputIt first, InputIt last, OutputIt out
+) const {
+  std::array<KeyT,       kSearchGroupSize> keys{};
+  std::array<node_ind_t, kSearchGroupSize> cur_node_inds{};
+  std::array<node_ind_t, kSearchGroupSize> candidate_inds{};
+
+  while (first != last) {
+    std::size_t group_size = 0;
+    for (; group_size < kSearchGroupSize && first != last; ++group_size, ++first) {
+      keys[group_size]           = *first;
+      cur_node_inds[group_size]  = root_node_ind_;
+      candidate_inds[group_size] = kEndSentinel;
+    }
+
+    for (bool has_unfinished = true; has_unfinished; ) {
+      has_unfinished = false;
+      for (std::size_t lane = 0; lane < group_size; ++lane) {
+        if (cur_node_inds[lane] == kNullNodeInd) {
+          continue;
+        }
+
+        const node_ind_t next_node_ind = find_node_after_key_step(
+          cur_node_inds[lane], keys[lane], false, candidate_inds[lane]
+        );
+        nodes_buffer_.prefetch(next_node_ind);
+        cur_node_inds[lane] = next_node_ind;
+        has_unfinished |= next_node_ind != kNullNodeInd;
+      }
+    }
+
+    for (std::size_t lane = 0; lane < group_size; ++lane) {
+      *out = const_iterator(*this, candidate_inds[lane]);
+      ++out;
+    }
+  }
+}
+
+// count_range(low_key, high_key) is number of keys <= high_key minus number of keys < low_key,
+// these are two independent descents from root: lanes 2 * i and 2 * i + 1 belong to i-th range
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+template <typename InputIt, typename OutputIt>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::count_range_batch(
+  InputIt first, InputIt last, OutputIt out
+) const {
+  static constexpr std::size_t kLanesCount = 2 * kSearchGroupSize;
+  std::array<KeyT,        kLanesCount> keys{};
+  std::array<node_ind_t,  kLanesCount> cur_node_inds{};
+  std::array<std::size_t, kLanesCount> counts{};
+  std::array<bool,        kLanesCount> is_right_son{}; // current node was reached by right edge
+
+  while (first != last) {
+    std::size_t lanes_count = 0;
+    for (; lanes_count < kLanesCount && first != last; lanes_count += 2, ++first) {
+      const auto& [low_key, high_key] = *first;
+      const node_ind_t start_node_ind = comparator_(high_key, low_key) ? kNullNodeInd : root_node_ind_;
+      keys[lanes_count]     = high_key;
+      keys[lanes_count + 1] = low_key;
+      for (std::size_t lane = lanes_count; lane < lanes_count + 2; ++lane) {
+        cur_node_inds[lane] = start_node_ind;
+        counts[lane]        = 0;
+        is_right_son[lane]  = false;
+      }
+    }
+
+    for (bool has_unfinished = true; has_unfinished; ) {
+      has_unfinished = false;
+      for (std::size_t lane = 0; lane < lanes_count; ++lane) {
+        const node_ind_t cur_node_ind = cur_node_inds[lane];
+        if (cur_node_ind == kNullNodeInd) {
+          continue;
+        }
+
+        const KeyT& cur_key = nodes_buffer_.key(cur_node_ind);
+        const bool is_before_key = lane % 2 == 0
+          ? !comparator_(keys[lane], cur_key)
+          :  comparator_(cur_key, keys[lane]);
+
+        // going right skips node with its left subtree: size(node) - size(right son). Size of
+        // right son is subtracted, when it's visited, so only one node per level is waited for
+        const std::size_t cur_size      = nodes_buffer_.subtree_size(cur_node_ind);
+        const std::size_t add_mask      = std::size_t{0} - static_cast<std::size_t>(is_before_key);
+        const std::size_t subtract_mask = std::size_t{0} - static_cast<std::size_t>(is_right_son[lane]);
+        counts[lane] += (cur_size & add_mask) - (cur_size & subtract_mask);
+
+        const node_ind_t next_node_ind = nodes_buffer_.son(cur_node_ind, is_before_key);
+        nodes_buffer_.prefetch(next_node_ind);
+        cur_node_inds[lane] = next_node_ind;
+        is_right_son[lane]  = is_before_key;
+        has_unfinished |= next_node_ind != kNullNodeInd;
+      }
+    }
+
+    for (std::size_t lane = 0; lane < lanes_count; lane += 2) {
+      *out = counts[lane] - counts[lane + 1];
+      ++out;
+    }
+  }
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "AVL_tree_fwd.hpp"
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+template <typename InputIt, typename>
+AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::AVL_tree_t(
+  InputIt first, InputIt last
+) {
+  std::vector<KeyT> keys(first, last);
+  std::sort(keys.begin(), keys.end(), comparator_);
+  auto are_equal = [this](const KeyT& lhs, const KeyT& rhs) {
+    return !comparator_(lhs, rhs) && !comparator_(rhs, lhs);
+  };
+  keys.erase(std::unique(keys.begin(), keys.end(), are_equal), keys.end());
+
+  build_from_sorted_unique(keys);
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+template <typename InputIt>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::assign_sorted(
+  InputIt first, InputIt last
+) {
+  std::vector<KeyT> keys;
+  if constexpr (std::is_base_of_v<
+      std::forward_iterator_tag,
+      typename std::iterator_traits<InputIt>::iterator_category>) {
+    keys.reserve(std::distance(first, last));
+  }
+
+  for (; first != last; ++first) {
+    assert((keys.empty() || !comparator_(*first, keys.back())) && "range is not sorted");
+    if (keys.empty() || comparator_(keys.back(), *first)) {
+      keys.push_back(*first);
+    }
+  }
+
+  build_from_sorted_unique(keys);
+}
+
+// Root of every subrange is its middle key, so sizes of sons differ at most by one
+// and tree is perfectly balanced. Nodes are numbered in BFS order: top levels,
+// that are read by every descent, are packed at the start of nodes_buffer_.
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::build_from_sorted_unique(
+  const std::vector<KeyT>& keys
+) {
+  // tree is rebuilt in place by insert_sorted_batch() and merge(), so it's left
+  // unchanged, if keys don't fit
+  if (keys.size() > max_size()) {
+    throw std::length_error("AVL_tree_t: too many keys for chosen node index type, at most " +
+                            std::to_string(max_size()) + " keys fit");
+  }
+
+  nodes_buffer_.reserve(keys.size() + 1);
+  clear();
+  if (keys.empty()) {
+    return;
+  }
+
+  struct subrange_t {
+    std::size_t begin;
+    std::size_t end;
+    node_ind_t  parent_ind;
+    bool        is_right_son;
+  };
+
+  std::vector<subrange_t> bfs_queue;
+  bfs_queue.reserve(keys.size());
+  bfs_queue.push_back({0, keys.size(), kNullNodeInd, false});
+
+  for (std::size_t queue_head = 0; queue_head < bfs_queue.size(); ++queue_head) {
+    const subrange_t range = bfs_queue[queue_head];
+    const std::size_t range_size = range.end - range.begin;
+    const std::size_t middle     = range.begin + range_size / 2;
+
+    node_ind_t node_ind = nodes_buffer_.emplace_back(keys[middle]);
+    nodes_buffer_.set_subtree_size(node_ind, range_size);
+
+    // height of such tree is floor(log2(size)) + 1
+    node_height_t height = 0;
+    for (std::size_t rest = range_size; rest != 0; rest >>= 1) {
+      ++height;
+    }
+    nodes_buffer_.set_height(node_ind, height);
+
+    nodes_buffer_.parent(node_ind) = range.parent_ind;
+    if (range.parent_ind == kNullNodeInd) {
+      root_node_ind_ = node_ind;
+    } else if (range.is_right_son) {
+      nodes_buffer_.right(range.parent_ind) = node_ind;
+    } else {
+      nodes_buffer_.left(range.parent_ind)  = node_ind;
+    }
+
+    if (range.begin < middle) {
+      bfs_queue.push_back({range.begin, middle, node_ind, false});
+    }
+    if (middle + 1 < range.end) {
+      bfs_queue.push_back({middle + 1, range.end, node_ind, true});
+    }
+  }
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+template <typename InputIt>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::insert_batch(
+  InputIt first, InputIt last
+) {
+  using iterator_category = typename std::iterator_traits<InputIt>::iterator_category;
+  if constexpr (std::is_base_of_v<std::forward_iterator_tag, iterator_category>) {
+    // single key doesn't need copy, sort and unique, e.g. when 'k' and 'q' queries alternate
+    if (first != last && std::next(first) == last) {
+      insert(*first);
+      return;
+    }
+  }
+
+  std::vector<KeyT> batch(first, last);
+  std::sort(batch.begin(), batch.end(), comparator_);
+  auto are_equal = [this](const KeyT& lhs, const KeyT& rhs) {
+    return !comparator_(lhs, rhs) && !comparator_(rhs, lhs);
+  };
+  batch.erase(std::unique(batch.begin(), batch.end(), are_equal), batch.end());
+  insert_sorted_batch(batch.begin(), batch.end());
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+template <typename ForwardIt>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::insert_sorted_batch(
+  ForwardIt first, ForwardIt last
+) {
+  if (first == last) {
+    return;
+  }
+  if (std::next(first) == last) {
+    insert(*first);
+    return;
+  }
+
+  const std::size_t batch_size = static_cast<std::size_t>(std::distance(first, last));
+  if (batch_size * kRebuildBatchDivisor >= size()) {
+    // linear merge is cheaper than m separate descents with rotations
+    std::vector<KeyT> tree_keys;
+    tree_keys.reserve(size());
+    for (auto it = cbegin(); it != cend(); ++it) {
+      tree_keys.push_back(*it);
+    }
+
+    std::vector<KeyT> merged_keys;
+    merged_keys.reserve(tree_keys.size() + batch_size);
+    std::set_union(tree_keys.begin(), tree_keys.end(), first, last,
+                   std::back_inserter(merged_keys), comparator_);
+
+    build_from_sorted_unique(merged_keys);
+    return;
+  }
+
+  // empty tree is always rebuilt above, so there is root to descend from
+  node_ind_t prev_node_ind = insert_into_subtree(root_node_ind_, *first);
+  for (auto it = std::next(first); it != last; ++it) {
+    node_ind_t start_node_ind = find_subtree_for_next_key(prev_node_ind, *it);
+    prev_node_ind = insert_into_subtree(start_node_ind, *it);
+  }
+}
+
+// Keys are inserted in increasing order, so instead of descending from root,
+// we go up from node of previous key only until subtree, that contains next key.
+// Subtree of left son is bounded from above by key of its parent.
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+[[nodiscard]] auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::
+find_subtree_for_next_key(node_ind_t prev_node_ind, const KeyT& next_key) const -> node_ind_t {
+  node_ind_t cur_node_ind = prev_node_ind;
+  node_ind_t parent_ind = nodes_buffer_.parent(cur_node_ind);
+  while (parent_ind != kNullNodeInd) {
+    bool is_left_son = nodes_buffer_.left(parent_ind) == cur_node_ind;
+    if (is_left_son && comparator_(next_key, nodes_buffer_.key(parent_ind))) {
+      break;
+    }
+
+    cur_node_ind = parent_ind;
+    parent_ind = nodes_buffer_.parent(cur_node_ind);
+  }
+
+  return cur_node_ind;
+}
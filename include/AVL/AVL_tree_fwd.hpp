@@ -3,5 +3,5 @@
 #include <cstdint>
 #include <functional>
 
-template <typename KeyT, typename ComparatorT>
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
 class AVL_tree_t;
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include "AVL_tree_fwd.hpp"
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::join(
+  AVL_tree_t&& left, const KeyT& pivot, AVL_tree_t&& right
+) -> AVL_tree_t {
+  assert((left.empty() ||
+          left.comparator_(left.nodes_buffer_.key(left.select_node(left.size() - 1)), pivot)) &&
+         "keys of left tree should be less than pivot");
+  assert((right.empty() ||
+          right.comparator_(pivot, right.nodes_buffer_.key(right.select_node(0)))) &&
+         "keys of right tree should be greater than pivot");
+
+  // nodes of smaller tree are copied, larger one gives away its whole arena
+  const bool is_left_larger = left.size() >= right.size();
+  AVL_tree_t& smaller_tree = is_left_larger ? right : left;
+  AVL_tree_t result = std::move(is_left_larger ? left : right);
+
+  node_ind_t copied_root_ind = result.copy_subtree_from(smaller_tree, smaller_tree.root_node_ind_);
+  node_ind_t pivot_ind       = result.get_new_node(pivot);
+  if (is_left_larger) {
+    result.join_subtrees(result.root_node_ind_, pivot_ind, copied_root_ind);
+  } else {
+    result.join_subtrees(copied_root_ind, pivot_ind, result.root_node_ind_);
+  }
+
+  left.clear();
+  right.clear();
+  return result;
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::split(const KeyT& key) -> AVL_tree_t {
+  auto [less_root_ind, not_less_root_ind] = split_subtree(root_node_ind_, key);
+
+  AVL_tree_t not_less_tree;
+  not_less_tree.comparator_ = comparator_;
+  // both parts are still in current arena, only the smaller one is relocated
+  if (get_node_subtree_size(not_less_root_ind) > get_node_subtree_size(less_root_ind)) {
+    std::swap(nodes_buffer_,   not_less_tree.nodes_buffer_);
+    std::swap(free_list_head_, not_less_tree.free_list_head_);
+    not_less_tree.root_node_ind_ = not_less_root_ind;
+    root_node_ind_ = copy_subtree_from(not_less_tree, less_root_ind);
+    not_less_tree.free_subtree(less_root_ind);
+  } else {
+    root_node_ind_ = less_root_ind;
+    not_less_tree.root_node_ind_ = not_less_tree.copy_subtree_from(*this, not_less_root_ind);
+    free_subtree(not_less_root_ind);
+  }
+
+  return not_less_tree;
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::merge(AVL_tree_t&& other) {
+  if (other.empty()) {
+    return;
+  }
+  if (empty()) {
+    std::swap(*this, other);
+    return;
+  }
+
+  const bool is_other_greater = comparator_(
+    nodes_buffer_.key(select_node(size() - 1)), other.nodes_buffer_.key(other.select_node(0))
+  );
+  const bool is_other_less = comparator_(
+    other.nodes_buffer_.key(other.select_node(other.size() - 1)), nodes_buffer_.key(select_node(0))
+  );
+  if (!is_other_greater && !is_other_less) {
+    // key ranges overlap, so there is no pivot to join trees by
+    std::vector<KeyT> other_keys;
+    other_keys.reserve(other.size());
+    for (auto it = other.cbegin(); it != other.cend(); ++it) {
+      other_keys.push_back(*it);
+    }
+
+    other.clear();
+    insert_sorted_batch(other_keys.begin(), other_keys.end());
+    return;
+  }
+
+  // larger tree keeps its arena, nodes of smaller one are copied into it
+  bool is_other_right = is_other_greater;
+  if (other.size() > size()) {
+    std::swap(*this, other);
+    is_other_right = !is_other_right;
+  }
+
+  node_ind_t copied_root_ind = copy_subtree_from(other, other.root_node_ind_);
+  other.clear();
+  if (is_other_right) {
+    join_subtrees(root_node_ind_, copied_root_ind);
+  } else {
+    join_subtrees(copied_root_ind, root_node_ind_);
+  }
+}
+
+// ======================   private methods   ========================
+
+// Joins detached subtrees of current arena, all keys of left one are less than pivot key,
+// all keys of right one are greater. If heights differ by more than one, pivot is hung
+// on the inner spine of higher subtree next to the first node, that is at most one level
+// higher than other subtree, and retraced as a freshly inserted node.
+// Result becomes root_node_ind_ and is returned.
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::join_subtrees(
+  node_ind_t left_root_ind, node_ind_t pivot_ind, node_ind_t right_root_ind
+) -> node_ind_t {
+  const node_height_t  left_height = get_node_height(left_root_ind);
+  const node_height_t right_height = get_node_height(right_root_ind);
+  nodes_buffer_.parent(pivot_ind) = kNullNodeInd;
+
+  if (std::abs(left_height - right_height) <= 1) {
+    set_node_left_son (pivot_ind, left_root_ind);
+    set_node_right_son(pivot_ind, right_root_ind);
+    root_node_ind_ = pivot_ind;
+    return pivot_ind;
+  }
+
+  const bool is_left_higher = left_height > right_height;
+  const node_ind_t    lower_root_ind = is_left_higher ? right_root_ind : left_root_ind;
+  const node_height_t lower_height   = get_node_height(lower_root_ind);
+
+  root_node_ind_ = is_left_higher ? left_root_ind : right_root_ind;
+  node_ind_t parent_ind   = kNullNodeInd;
+  node_ind_t cur_node_ind = root_node_ind_;
+  while (get_node_height(cur_node_ind) > lower_height + 1) {
+    parent_ind   = cur_node_ind;
+    cur_node_ind = is_left_higher ? nodes_buffer_.right(cur_node_ind)
+                                  : nodes_buffer_.left (cur_node_ind);
+  }
+
+  if (is_left_higher) {
+    set_node_left_son (pivot_ind, cur_node_ind);
+    set_node_right_son(pivot_ind, right_root_ind);
+    nodes_buffer_.right(parent_ind) = pivot_ind;
+  } else {
+    set_node_left_son (pivot_ind, left_root_ind);
+    set_node_right_son(pivot_ind, cur_node_ind);
+    nodes_buffer_.left(parent_ind)  = pivot_ind;
+  }
+  nodes_buffer_.parent(pivot_ind) = parent_ind;
+
+  retrace(parent_ind, static_cast<std::ptrdiff_t>(get_node_subtree_size(lower_root_ind) + 1));
+  return root_node_ind_;
+}
+
+// same as above, but minimal node of right subtree is detached and used as pivot
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::join_subtrees(
+  node_ind_t left_root_ind, node_ind_t right_root_ind
+) -> node_ind_t {
+  if (right_root_ind == kNullNodeInd) {
+    root_node_ind_ = left_root_ind;
+    return left_root_ind;
+  }
+
+  root_node_ind_ = right_root_ind;
+  node_ind_t pivot_ind = right_root_ind;
+  while (nodes_buffer_.left(pivot_ind) != kNullNodeInd) {
+    pivot_ind = nodes_buffer_.left(pivot_ind);
+  }
+
+  const node_ind_t parent_ind = nodes_buffer_.parent(pivot_ind);
+  replace_son(parent_ind, pivot_ind, nodes_buffer_.right(pivot_ind));
+  retrace(parent_ind, -1);
+
+  return join_subtrees(left_root_ind, pivot_ind, root_node_ind_);
+}
+
+// Splits subtree into detached subtrees with keys less than key and not less than key.
+// Every node on search path is joined with one of its sons' subtrees, heights of joined
+// subtrees grow along the path, so total work is O(log n).
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::split_subtree(
+  node_ind_t subtree_root_ind, const KeyT& key
+) -> std::pair<node_ind_t, node_ind_t> {
+  if (subtree_root_ind == kNullNodeInd) {
+    return {kNullNodeInd, kNullNodeInd};
+  }
+
+  const node_ind_t left_ind  = nodes_buffer_.left(subtree_root_ind);
+  const node_ind_t right_ind = nodes_buffer_.right(subtree_root_ind);
+  for (node_ind_t kid_ind : {left_ind, right_ind}) {
+    if (kid_ind != kNullNodeInd) {
+      nodes_buffer_.parent(kid_ind) = kNullNodeInd;
+    }
+  }
+
+  if (comparator_(nodes_buffer_.key(subtree_root_ind), key)) {
+    auto [less_ind, not_less_ind] = split_subtree(right_ind, key);
+    return {join_subtrees(left_ind, subtree_root_ind, less_ind), not_less_ind};
+  }
+
+  auto [less_ind, not_less_ind] = split_subtree(left_ind, key);
+  return {less_ind, join_subtrees(not_less_ind, subtree_root_ind, right_ind)};
+}
+
+// copies subtree of other tree into current arena keeping its shape, returns root of copy
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::copy_subtree_from(
+  const AVL_tree_t& other, node_ind_t other_node_ind
+) -> node_ind_t {
+  if (other_node_ind == kNullNodeInd) {
+    return kNullNodeInd;
+  }
+
+  node_ind_t node_ind = get_new_node(other.nodes_buffer_.key(other_node_ind));
+  node_ind_t  left_ind = copy_subtree_from(other, other.nodes_buffer_.left (other_node_ind));
+  node_ind_t right_ind = copy_subtree_from(other, other.nodes_buffer_.right(other_node_ind));
+  set_node_left_son (node_ind, left_ind);
+  set_node_right_son(node_ind, right_ind);
+
+  return node_ind;
+}
+
+// returns all nodes of subtree to free list
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::free_subtree(node_ind_t subtree_root_ind) {
+  if (subtree_root_ind == kNullNodeInd) {
+    return;
+  }
+
+  const node_ind_t left_ind  = nodes_buffer_.left(subtree_root_ind);
+  const node_ind_t right_ind = nodes_buffer_.right(subtree_root_ind);
+  free_node(subtree_root_ind);
+  free_subtree(left_ind);
+  free_subtree(right_ind);
+}
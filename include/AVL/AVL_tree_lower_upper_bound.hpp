@@ -2,63 +2,186 @@
 
 #include "AVL_tree_fwd.hpp"
 
-template <typename KeyT, typename ComparatorT>
-[[nodiscard]] auto AVL_tree_t<KeyT, ComparatorT>::
+// returns the first node, whose key is not less than key (or greater than key, if skip_equal is set)
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+[[nodiscard]] auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::
 general_find_node_after_key(KeyT key, bool skip_equal) const -> node_ind_t {
-  if (!root_node_ind_) { // tree is empty
-    return kEndSentinel;
-  }
-
+  // the last node, where descent went left, is the closest one after key
   node_ind_t candidate_ind = kEndSentinel;
   node_ind_t cur_node_ind = root_node_ind_;
   while (cur_node_ind != kNullNodeInd) {
-    const node_t& cur_node = get_node(cur_node_ind);
-    
-    if (!skip_equal && cur_node.key == key) {
-      // exact match and it's lower bound (no skip)
-      return cur_node_ind;
-    }
-    
-    if (comparator_(key, cur_node.key)) {
-      // current node is greater than key - it's a potential candidate
-      candidate_ind = cur_node_ind;
-      // search left to find a closer (smaller but still >= key) candidate
-      cur_node_ind = cur_node.left;
-    } else {
-      // current node is less than or equal to key
-      // if equal and skip_equal is true, we need to go right
-      // if less than, we need to go right to find larger values
-      cur_node_ind = cur_node.right;
-    }
+    cur_node_ind = find_node_after_key_step(cur_node_ind, key, skip_equal, candidate_ind);
   }
-  
+
   return candidate_ind;
 }
 
-template <typename KeyT, typename ComparatorT>
-auto AVL_tree_t<KeyT, ComparatorT>::
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+[[nodiscard]] auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::find_node_after_key_step(
+  node_ind_t cur_node_ind, const KeyT& key, bool skip_equal, node_ind_t& candidate_ind
+) const -> node_ind_t {
+  const KeyT& cur_key = nodes_buffer_.key(cur_node_ind);
+  // skip_equal doesn't change during descent, so this branch is always predicted
+  const bool is_before_key = skip_equal
+    ? !comparator_(key, cur_key)
+    :  comparator_(cur_key, key);
+
+  if constexpr (kIsBranchFreeSearch) {
+    const node_ind_t keep_mask = node_ind_t{0} - static_cast<node_ind_t>(is_before_key);
+    candidate_ind = (candidate_ind & keep_mask) | (cur_node_ind & ~keep_mask);
+    return nodes_buffer_.son(cur_node_ind, is_before_key);
+  } else {
+    if (is_before_key) {
+      return nodes_buffer_.right(cur_node_ind);
+    }
+
+    // current node is after key, closer candidate can be only in left subtree
+    candidate_ind = cur_node_ind;
+    return nodes_buffer_.left(cur_node_ind);
+  }
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::
 lower_bound(KeyT key) -> iterator {
   node_ind_t ans_node_ind = general_find_node_after_key(key, false);
   return iterator(*this, ans_node_ind);
 }
 
-template <typename KeyT, typename ComparatorT>
-auto AVL_tree_t<KeyT, ComparatorT>::
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::
 upper_bound(KeyT key) -> iterator {
   node_ind_t ans_node_ind = general_find_node_after_key(key, true);
   return iterator(*this, ans_node_ind);
 }
 
-template <typename KeyT, typename ComparatorT>
-auto AVL_tree_t<KeyT, ComparatorT>::
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::
 lower_bound(KeyT key) const -> const_iterator {
   node_ind_t ans_node_ind = general_find_node_after_key(key, false);
   return const_iterator(*this, ans_node_ind);
 }
 
-template <typename KeyT, typename ComparatorT>
-auto AVL_tree_t<KeyT, ComparatorT>::
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::
 upper_bound(KeyT key) const -> const_iterator {
   node_ind_t ans_node_ind = general_find_node_after_key(key, true);
   return const_iterator(*this, ans_node_ind);
 }
+
+// counts keys of subtree that go before key (or are equal to it, if include_equal is set)
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+[[nodiscard]] std::size_t AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::count_keys_before(
+  node_ind_t subtree_root_ind, const KeyT& key, bool include_equal
+) const {
+  std::size_t cnt_keys = 0;
+  node_ind_t cur_node_ind = subtree_root_ind;
+  while (cur_node_ind != kNullNodeInd) {
+    const KeyT& cur_key = nodes_buffer_.key(cur_node_ind);
+    bool is_before_key = include_equal
+      ? !comparator_(key, cur_key)
+      :  comparator_(cur_key, key);
+
+    if constexpr (kIsBranchFreeSearch) {
+      const std::size_t take_mask = std::size_t{0} - static_cast<std::size_t>(is_before_key);
+      cnt_keys += (get_node_subtree_size(nodes_buffer_.left(cur_node_ind)) + 1) & take_mask;
+      cur_node_ind = nodes_buffer_.son(cur_node_ind, is_before_key);
+    } else if (is_before_key) {
+      // whole left subtree and current node are before key
+      cnt_keys += get_node_subtree_size(nodes_buffer_.left(cur_node_ind)) + 1;
+      cur_node_ind = nodes_buffer_.right(cur_node_ind);
+    } else {
+      cur_node_ind = nodes_buffer_.left(cur_node_ind);
+    }
+  }
+
+  return cnt_keys;
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+std::size_t AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::
+count_less(const KeyT& key) const {
+  return count_keys_before(root_node_ind_, key, false);
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+std::size_t AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::
+count_range(const KeyT& low_key, const KeyT& high_key) const {
+  if (comparator_(high_key, low_key)) {
+    return 0;
+  }
+
+  // find first node, that lies inside of [low_key, high_key], paths to both bounds split there
+  node_ind_t split_node_ind = root_node_ind_;
+  while (split_node_ind != kNullNodeInd) {
+    const KeyT& cur_key = nodes_buffer_.key(split_node_ind);
+    if (comparator_(cur_key, low_key)) {
+      split_node_ind = nodes_buffer_.right(split_node_ind);
+    } else if (comparator_(high_key, cur_key)) {
+      split_node_ind = nodes_buffer_.left(split_node_ind);
+    } else {
+      break;
+    }
+  }
+
+  if (split_node_ind == kNullNodeInd) {
+    return 0;
+  }
+
+  const node_ind_t left_ind  = nodes_buffer_.left(split_node_ind);
+  const node_ind_t right_ind = nodes_buffer_.right(split_node_ind);
+  std::size_t cnt_in_left  = get_node_subtree_size(left_ind) -
+                             count_keys_before(left_ind, low_key, false);
+  std::size_t cnt_in_right = count_keys_before(right_ind, high_key, true);
+
+  return cnt_in_left + 1 + cnt_in_right;
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+[[nodiscard]] auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::
+select_node(std::size_t k) const -> node_ind_t {
+  if (k >= size()) {
+    return kEndSentinel;
+  }
+
+  node_ind_t cur_node_ind = root_node_ind_;
+  while (true) {
+    const node_ind_t left_ind = nodes_buffer_.left(cur_node_ind);
+    std::size_t left_size = get_node_subtree_size(left_ind);
+    if (k == left_size) {
+      return cur_node_ind;
+    }
+
+    if (k < left_size) {
+      cur_node_ind = left_ind;
+    } else {
+      // skip whole left subtree and current node
+      k -= left_size + 1;
+      cur_node_ind = nodes_buffer_.right(cur_node_ind);
+    }
+  }
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::
+select(std::size_t k) -> iterator {
+  return iterator(*this, select_node(k));
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::
+select(std::size_t k) const -> const_iterator {
+  return const_iterator(*this, select_node(k));
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::
+nth_element(std::size_t k) -> iterator {
+  return select(k);
+}
+
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+auto AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::
+nth_element(std::size_t k) const -> const_iterator {
+  return select(k);
+}
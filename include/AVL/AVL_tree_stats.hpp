@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Events of tree updates, counted only if tree is compiled with AVL_COUNTERS_, otherwise zeros.
+// Counters live as long as tree and survive clear().
+struct AVL_operation_counters_t {
+  std::size_t inserted_nodes  = 0; // nodes created by descents of insert(), not by rebuilds
+  std::size_t freed_nodes     = 0; // nodes of erased keys
+  std::size_t rebalances      = 0; // balance_node() calls, that had to rotate
+  std::size_t left_rotations  = 0;
+  std::size_t right_rotations = 0;
+};
+
+// Snapshot of shape and memory of tree, see AVL_tree_t::stats(), O(n)
+struct AVL_tree_stats_t {
+  std::size_t size   = 0;
+  std::size_t height = 0;
+  // depth_histogram[depth] is number of keys at depth, root has depth 0
+  std::vector<std::size_t> depth_histogram;
+  // average number of nodes, that are visited by search of present key
+  double average_search_depth = 0;
+
+  std::size_t nodes_count    = 0; // used slots of node arena, including null node and free slots
+  std::size_t free_nodes     = 0; // slots of arena, that don't hold keys (null node isn't counted)
+  std::size_t nodes_capacity = 0; // slots, that are allocated
+  std::size_t node_bytes     = 0; // bytes of single slot
+  std::size_t memory_bytes   = 0; // nodes_capacity * node_bytes
+  double      bytes_per_key  = 0; // memory_bytes / size
+
+  bool are_counters_enabled = false;
+  AVL_operation_counters_t counters;
+
+  double rotations_per_insert() const {
+    return counters.inserted_nodes != 0
+      ? static_cast<double>(counters.left_rotations + counters.right_rotations) / counters.inserted_nodes
+      : 0.0;
+  }
+};
@@ -5,8 +5,8 @@
 
 #include "AVL_tree_fwd.hpp"
 
-template <typename KeyT, typename ComparatorT>
-void AVL_tree_t<KeyT, ComparatorT>::visualize_tree(
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::visualize_tree(
   const std::string& base_filename
 ) const {
   const std::string dot_filename = base_filename + ".dot";
@@ -28,8 +28,8 @@ void AVL_tree_t<KeyT, ComparatorT>::visualize_tree(
   open_png_file(png_filename);
 }
 
-template <typename KeyT, typename ComparatorT>
-void AVL_tree_t<KeyT, ComparatorT>::generate_dot(
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::generate_dot(
   const std::string dot_filename
 ) const {
   std::ofstream file_stream(dot_filename);
@@ -48,8 +48,8 @@ void AVL_tree_t<KeyT, ComparatorT>::generate_dot(
   file_stream << "}\n";
 }
 
-template <typename KeyT, typename ComparatorT>
-void AVL_tree_t<KeyT, ComparatorT>::generate_dot_recursive(
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::generate_dot_recursive(
   node_ind_t     cur_node_ind,
   node_ind_t     parent_node_ind,
   std::ofstream& file_stream
@@ -67,13 +67,12 @@ void AVL_tree_t<KeyT, ComparatorT>::generate_dot_recursive(
 
   generate_dot_for_vertex(cur_node_ind, file_stream);
 
-  const node_t& cur_node = get_node(cur_node_ind);
-  generate_dot_recursive(cur_node.left,  cur_node_ind, file_stream);
-  generate_dot_recursive(cur_node.right, cur_node_ind, file_stream);
+  generate_dot_recursive(nodes_buffer_.left(cur_node_ind),  cur_node_ind, file_stream);
+  generate_dot_recursive(nodes_buffer_.right(cur_node_ind), cur_node_ind, file_stream);
 }
 
-template <typename KeyT, typename ComparatorT>
-void AVL_tree_t<KeyT, ComparatorT>::open_png_file(
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::open_png_file(
   const std::string& png_filename
 ) const {
   // TODO: I hope this works fine, however I don't want to think about non linux systems for now
@@ -93,35 +92,34 @@ void AVL_tree_t<KeyT, ComparatorT>::open_png_file(
   }
 }
 
-template <typename KeyT, typename ComparatorT>
-void AVL_tree_t<KeyT, ComparatorT>::generate_dot_for_edge(
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::generate_dot_for_edge(
   node_ind_t     start,
   node_ind_t     finish,
   std::ofstream& file_stream
 ) const {
-  bool is_left_son = get_node(start).left == finish;
+  bool is_left_son = nodes_buffer_.left(start) == finish;
   const std::string kEdgeColor = is_left_son ? "orange" : "lightblue";
   file_stream << start << " -> " << finish
     << " [color=" << kEdgeColor << ", fontcolor=white, weight=1]";
 }
 
-template <typename KeyT, typename ComparatorT>
-std::string AVL_tree_t<KeyT, ComparatorT>::get_node_ind_name(
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+std::string AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::get_node_ind_name(
   node_ind_t node_ind
 ) {
   return node_ind == kNullNodeInd ? "nil" : std::to_string(node_ind);
 }
 
-template <typename KeyT, typename ComparatorT>
-void AVL_tree_t<KeyT, ComparatorT>::generate_dot_for_vertex(
+template <typename KeyT, typename ComparatorT, typename NodeIndT, typename StorageTagT>
+void AVL_tree_t<KeyT, ComparatorT, NodeIndT, StorageTagT>::generate_dot_for_vertex(
   node_ind_t     cur_node_ind,
   std::ofstream& file_stream
 ) const {
-  const node_t& cur_node = get_node(cur_node_ind);
-  const std::string  kLeftKidName = get_node_ind_name(cur_node.left);
-  const std::string kRightKidName = get_node_ind_name(cur_node.right);
-  file_stream << cur_node_ind << " [label=\"key: " << cur_node.key
-              << ", h: " << static_cast<int>(cur_node.height)
+  const std::string  kLeftKidName = get_node_ind_name(nodes_buffer_.left(cur_node_ind));
+  const std::string kRightKidName = get_node_ind_name(nodes_buffer_.right(cur_node_ind));
+  file_stream << cur_node_ind << " [label=\"key: " << nodes_buffer_.key(cur_node_ind)
+              << ", h: " << static_cast<int>(nodes_buffer_.height(cur_node_ind))
               << "\nid: " << cur_node_ind
               << ", l: " << kLeftKidName << ", r: " << kRightKidName << "\"];\n";
 }
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+// Wrapper for workload with one writer thread and many reader threads (Left-Right technique).
+// Two copies of tree are kept: readers work with the published one, writer applies update
+// to the other copy, publishes it, waits until readers leave the old copy and then repeats
+// the same update on it. So readers never lock, never wait and always see immutable tree,
+// the price is doubled memory and every update done twice.
+// Arrival and departure of reader is single increment and decrement of counter, counters
+// are striped over cache lines, so that readers on different cores don't share one line.
+// TreeT is tree with insert(), erase() and const queries, e.g. compact_AVL_tree_t<int>
+template <typename TreeT>
+class left_right_tree_t {
+ public:
+  using key_type = typename TreeT::key_type;
+
+ public:
+  left_right_tree_t() = default;
+
+  explicit left_right_tree_t(const TreeT& tree)
+    : trees_{tree, tree} {}
+
+  left_right_tree_t(const left_right_tree_t&) = delete;
+  left_right_tree_t& operator=(const left_right_tree_t&) = delete;
+
+  // updates are serialized, readers are not blocked by them
+  void insert(const key_type& key) {
+    modify([&key](TreeT& tree) { tree.insert(key); });
+  }
+
+  void erase(const key_type& key) {
+    modify([&key](TreeT& tree) { tree.erase(key); });
+  }
+
+  // func(TreeT&) is applied to both copies one after another,
+  // so it has to change them in the same way (e.g. no randomness)
+  template <typename FuncT>
+  void modify(FuncT&& func) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+
+    const std::size_t published_ind = published_ind_.load(std::memory_order_relaxed);
+    func(trees_[1 - published_ind]);
+    published_ind_.store(1 - published_ind);
+
+    wait_for_readers_of_old_version();
+    func(trees_[published_ind]);
+  }
+
+  // func(const TreeT&) runs on consistent version of tree, that doesn't change during the call,
+  // result must not refer into tree (e.g. iterators), because tree changes after the call
+  template <typename FuncT>
+  auto read(FuncT&& func) const {
+    read_indicator_t& read_indicator = read_indicators_[version_ind_.load()];
+    read_guard_t guard(read_indicator);
+
+    return func(trees_[published_ind_.load()]);
+  }
+
+  std::size_t count_range(const key_type& low_key, const key_type& high_key) const {
+    return read([&](const TreeT& tree) {
+      return tree.count_range(low_key, high_key);
+    });
+  }
+
+  // the smallest key, that is not less than key
+  std::optional<key_type> lower_bound(const key_type& key) const {
+    return read([&](const TreeT& tree) -> std::optional<key_type> {
+      auto key_it = tree.lower_bound(key);
+      if (key_it == tree.end()) {
+        return std::nullopt;
+      }
+
+      return *key_it;
+    });
+  }
+
+  std::size_t size() const {
+    return read([](const TreeT& tree) {
+      return tree.size();
+    });
+  }
+
+ private:
+  static constexpr std::size_t kCacheLineSize = 64;
+  static constexpr std::size_t kStripesCount  = 32;
+
+ private:
+  class read_indicator_t {
+   public:
+    void arrive() { counters_[current_thread_stripe()].value.fetch_add(1); }
+    void depart() { counters_[current_thread_stripe()].value.fetch_sub(1); }
+
+    bool is_empty() const {
+      for (const counter_t& counter : counters_) {
+        if (counter.value.load() != 0) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+   private:
+    // every thread always uses the same stripe, threads get stripes in round robin order
+    static std::size_t current_thread_stripe() {
+      static std::atomic<std::size_t> next_stripe{0};
+      thread_local const std::size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed) %
+                                              kStripesCount;
+      return stripe;
+    }
+
+   private:
+    struct alignas(kCacheLineSize) counter_t {
+      std::atomic<std::ptrdiff_t> value{0};
+    };
+
+    std::array<counter_t, kStripesCount> counters_;
+  };
+
+  // departs even if reader's function throws
+  class read_guard_t {
+   public:
+    explicit read_guard_t(read_indicator_t& read_indicator)
+      : read_indicator_(read_indicator) {
+      read_indicator_.arrive();
+    }
+
+    read_guard_t(const read_guard_t&) = delete;
+    read_guard_t& operator=(const read_guard_t&) = delete;
+
+    ~read_guard_t() {
+      read_indicator_.depart();
+    }
+
+   private:
+    read_indicator_t& read_indicator_;
+  };
+
+  // readers, that could have seen old published_ind_, arrived at one of two read indicators,
+  // first drain the other one, switch new readers to it and then drain the current one
+  void wait_for_readers_of_old_version() {
+    const std::size_t prev_version_ind = version_ind_.load(std::memory_order_relaxed);
+    const std::size_t next_version_ind = 1 - prev_version_ind;
+
+    wait_until_empty(read_indicators_[next_version_ind]);
+    version_ind_.store(next_version_ind);
+    wait_until_empty(read_indicators_[prev_version_ind]);
+  }
+
+  static void wait_until_empty(const read_indicator_t& read_indicator) {
+    while (!read_indicator.is_empty()) {
+      std::this_thread::yield();
+    }
+  }
+
+ private:
+  std::array<TreeT, 2>                    trees_;
+  std::atomic<std::size_t>                published_ind_{0}; // copy of tree, that is used by readers
+  std::atomic<std::size_t>                version_ind_{0};   // read indicator for arriving readers
+  mutable std::array<read_indicator_t, 2> read_indicators_;
+  std::mutex                              writer_mutex_;
+};
@@ -0,0 +1,346 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "AVL/AVL_tree.hpp"
+
+// Partition of key space into ranges: shard i owns keys in [boundaries[i - 1], boundaries[i]),
+// the first shard owns all keys before boundaries[0], the last one all keys from boundaries.back().
+// Any partition, that is used by sharded_avl_t, has to provide shards_count() and shard_of(key),
+// that doesn't decrease with key, so that keys of [low_key, high_key] live in shards
+// shard_of(low_key), ..., shard_of(high_key).
+template <typename KeyT, typename ComparatorT = std::less<KeyT>>
+class range_partition_t {
+ public:
+  // single shard
+  range_partition_t() = default;
+
+  // boundaries have to be sorted
+  explicit range_partition_t(std::vector<KeyT> boundaries)
+    : boundaries_(std::move(boundaries)) {}
+
+  // splits [min_key, max_key] into ranges of equal length
+  static range_partition_t uniform(const KeyT& min_key, const KeyT& max_key, std::size_t shards_count) {
+    static_assert(std::is_arithmetic_v<KeyT>, "uniform partition is defined only for numbers");
+    const long double range_length = static_cast<long double>(max_key) - static_cast<long double>(min_key);
+
+    std::vector<KeyT> boundaries;
+    for (std::size_t shard_ind = 1; shard_ind < shards_count; ++shard_ind) {
+      boundaries.push_back(static_cast<KeyT>(min_key + range_length * shard_ind / shards_count));
+    }
+
+    return range_partition_t(std::move(boundaries));
+  }
+
+  // boundaries are quantiles of sample, so every shard gets about the same number of keys,
+  // if keys are distributed like sample. Empty sample gives single shard
+  template <typename InputIt>
+  static range_partition_t from_sample(InputIt first, InputIt last, std::size_t shards_count) {
+    std::vector<KeyT> sample(first, last);
+    std::sort(sample.begin(), sample.end(), ComparatorT{});
+
+    std::vector<KeyT> boundaries;
+    if (!sample.empty()) {
+      for (std::size_t shard_ind = 1; shard_ind < shards_count; ++shard_ind) {
+        boundaries.push_back(sample[shard_ind * sample.size() / shards_count]);
+      }
+    }
+
+    return range_partition_t(std::move(boundaries));
+  }
+
+  std::size_t shards_count() const { return boundaries_.size() + 1; }
+
+  std::size_t shard_of(const KeyT& key) const {
+    return std::upper_bound(boundaries_.begin(), boundaries_.end(), key, ComparatorT{}) - boundaries_.begin();
+  }
+
+  const std::vector<KeyT>& boundaries() const { return boundaries_; }
+
+ private:
+  std::vector<KeyT> boundaries_;
+};
+
+// Set of keys, that is split between shards by partition of key space. Every shard has its own
+// tree and worker thread, that is the only one touching this tree, so updates of different
+// shards run in parallel. Updates are routed by key into pending batch of shard, full batch
+// is handed over to worker through its queue, so locks are taken once per batch, not per key.
+// count_range() is sent only to shards, that overlap with range, and sums their answers.
+// All methods have to be called from one thread, that owns service, queries see all updates,
+// that were submitted before them.
+// TreeT is tree with insert(), erase(), count_range() and size(), e.g. compact_AVL_tree_t<KeyT>
+template <typename KeyT,
+          typename TreeT = compact_AVL_tree_t<KeyT>,
+          typename PartitionT = range_partition_t<KeyT>>
+class sharded_avl_t {
+ private:
+  enum class operation_type_t {
+    kInsert,
+    kErase,
+    kCountRange,
+    kSize
+  };
+
+  // owner thread waits on it until all queried shards have answered
+  class completion_t {
+   public:
+    explicit completion_t(std::size_t answers_count)
+      : remaining_answers_count_(answers_count) {}
+
+    void add_answers(std::size_t answers_count) {
+      // notified under lock, so that waiter can't destroy completion before worker leaves it
+      std::lock_guard<std::mutex> lock(mutex_);
+      remaining_answers_count_ -= answers_count;
+      if (remaining_answers_count_ == 0) {
+        is_done_.notify_one();
+      }
+    }
+
+    void wait() {
+      std::unique_lock<std::mutex> lock(mutex_);
+      is_done_.wait(lock, [this]() { return remaining_answers_count_ == 0; });
+    }
+
+   private:
+    std::mutex              mutex_;
+    std::condition_variable is_done_;
+    std::size_t             remaining_answers_count_;
+  };
+
+  struct operation_t {
+    operation_type_t type;
+    KeyT             key;
+    KeyT             high_key{};             // only for count range
+    std::size_t*     answer     = nullptr;   // only for queries
+    completion_t*    completion = nullptr;   // only for queries
+  };
+
+  using batch_t = std::vector<operation_t>;
+
+  struct shard_t {
+    TreeT                   tree;          // touched only by worker
+    batch_t                 pending_batch; // touched only by owner thread
+    std::mutex              mutex;
+    std::condition_variable has_work;
+    std::condition_variable has_space;
+    std::vector<batch_t>    queue;         // guarded by mutex
+    bool                    should_stop{}; // guarded by mutex
+    std::thread             worker;
+  };
+
+ public:
+  explicit sharded_avl_t(PartitionT partition = PartitionT(), std::size_t batch_size = kDefaultBatchSize)
+    : partition_(std::move(partition)), batch_size_(std::max<std::size_t>(batch_size, 1)) {
+    for (std::size_t shard_ind = 0; shard_ind < partition_.shards_count(); ++shard_ind) {
+      shards_.push_back(std::make_unique<shard_t>());
+      shards_.back()->pending_batch.reserve(batch_size_);
+      shards_.back()->worker = std::thread(run_worker, std::ref(*shards_.back()));
+    }
+  }
+
+  sharded_avl_t(const sharded_avl_t&) = delete;
+  sharded_avl_t& operator=(const sharded_avl_t&) = delete;
+
+  // submitted updates are applied before workers stop
+  ~sharded_avl_t() {
+    flush();
+    for (auto& shard : shards_) {
+      {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->should_stop = true;
+      }
+      shard->has_work.notify_one();
+    }
+    for (auto& shard : shards_) {
+      shard->worker.join();
+    }
+  }
+
+  void insert(const KeyT& key) {
+    submit(partition_.shard_of(key), {operation_type_t::kInsert, key});
+  }
+
+  void erase(const KeyT& key) {
+    submit(partition_.shard_of(key), {operation_type_t::kErase, key});
+  }
+
+  // number of keys in [low_key, high_key]
+  std::size_t count_range(const KeyT& low_key, const KeyT& high_key) {
+    return count_range_batch({{low_key, high_key}}).front();
+  }
+
+  // answers for all ranges are waited for once, so shards work on them in parallel
+  std::vector<std::size_t> count_range_batch(const std::vector<std::pair<KeyT, KeyT>>& ranges) {
+    std::vector<std::pair<std::size_t, std::size_t>> shards_spans;
+    shards_spans.reserve(ranges.size());
+    std::size_t answers_count = 0;
+    for (const auto& [low_key, high_key] : ranges) {
+      shards_spans.push_back(get_shards_span(low_key, high_key));
+      answers_count += shards_spans.back().second - shards_spans.back().first;
+    }
+
+    std::vector<std::size_t> shard_answers(answers_count);
+    completion_t completion(answers_count);
+    std::size_t answer_ind = 0;
+    for (std::size_t range_ind = 0; range_ind < ranges.size(); ++range_ind) {
+      const auto& [low_key, high_key] = ranges[range_ind];
+      for (std::size_t shard_ind = shards_spans[range_ind].first; shard_ind < shards_spans[range_ind].second; ++shard_ind) {
+        submit(shard_ind, {operation_type_t::kCountRange, low_key, high_key,
+                           &shard_answers[answer_ind++], &completion});
+      }
+    }
+    flush();
+    completion.wait();
+
+    std::vector<std::size_t> answers(ranges.size());
+    answer_ind = 0;
+    for (std::size_t range_ind = 0; range_ind < ranges.size(); ++range_ind) {
+      for (std::size_t shard_ind = shards_spans[range_ind].first; shard_ind < shards_spans[range_ind].second; ++shard_ind) {
+        answers[range_ind] += shard_answers[answer_ind++];
+      }
+    }
+
+    return answers;
+  }
+
+  // waits until all submitted updates are applied
+  std::size_t size() {
+    std::vector<std::size_t> shard_sizes(shards_.size());
+    completion_t completion(shards_.size());
+    for (std::size_t shard_ind = 0; shard_ind < shards_.size(); ++shard_ind) {
+      submit(shard_ind, {operation_type_t::kSize, KeyT{}, KeyT{}, &shard_sizes[shard_ind], &completion});
+    }
+    flush();
+    completion.wait();
+
+    std::size_t total_size = 0;
+    for (std::size_t shard_size : shard_sizes) {
+      total_size += shard_size;
+    }
+
+    return total_size;
+  }
+
+  // hands over not full batches to workers, doesn't wait until they are applied
+  void flush() {
+    for (auto& shard : shards_) {
+      hand_over_pending_batch(*shard);
+    }
+  }
+
+  std::size_t shards_count() const { return shards_.size(); }
+
+  const PartitionT& partition() const { return partition_; }
+
+ private:
+  // shards [first, last), that can contain keys of [low_key, high_key]
+  std::pair<std::size_t, std::size_t> get_shards_span(const KeyT& low_key, const KeyT& high_key) const {
+    const std::size_t first_shard_ind = partition_.shard_of(low_key);
+    const std::size_t last_shard_ind  = partition_.shard_of(high_key) + 1;
+
+    return {first_shard_ind, std::max(first_shard_ind, last_shard_ind)};
+  }
+
+  void submit(std::size_t shard_ind, const operation_t& operation) {
+    shard_t& shard = *shards_[shard_ind];
+    shard.pending_batch.push_back(operation);
+    if (shard.pending_batch.size() >= batch_size_) {
+      hand_over_pending_batch(shard);
+    }
+  }
+
+  // owner thread waits if worker falls too far behind
+  void hand_over_pending_batch(shard_t& shard) {
+    if (shard.pending_batch.empty()) {
+      return;
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(shard.mutex);
+      shard.has_space.wait(lock, [&shard]() { return shard.queue.size() < kMaxQueuedBatches; });
+      shard.queue.push_back(std::move(shard.pending_batch));
+    }
+    shard.has_work.notify_one();
+
+    shard.pending_batch = batch_t();
+    shard.pending_batch.reserve(batch_size_);
+  }
+
+  static void run_worker(shard_t& shard) {
+    std::vector<batch_t> batches;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        shard.has_work.wait(lock, [&shard]() { return !shard.queue.empty() || shard.should_stop; });
+        if (shard.queue.empty()) {
+          return; // stops only when all work is done
+        }
+        batches.swap(shard.queue);
+      }
+      shard.has_space.notify_one();
+
+      for (const batch_t& batch : batches) {
+        apply_batch(shard.tree, batch);
+      }
+      batches.clear();
+    }
+  }
+
+  // answers of consecutive queries with the same completion are reported at once
+  static void apply_batch(TreeT& tree, const batch_t& batch) {
+    completion_t* completion    = nullptr;
+    std::size_t   answers_count = 0;
+    for (const operation_t& operation : batch) {
+      switch (operation.type) {
+        case operation_type_t::kInsert:
+          tree.insert(operation.key);
+          break;
+        case operation_type_t::kErase:
+          tree.erase(operation.key);
+          break;
+        case operation_type_t::kCountRange:
+          *operation.answer = tree.count_range(operation.key, operation.high_key);
+          break;
+        case operation_type_t::kSize:
+          *operation.answer = tree.size();
+          break;
+        default:
+          break;
+      }
+
+      if (operation.completion != completion) {
+        if (completion != nullptr) {
+          completion->add_answers(answers_count);
+        }
+        completion    = operation.completion;
+        answers_count = 0;
+      }
+      if (completion != nullptr) {
+        ++answers_count;
+      }
+    }
+
+    if (completion != nullptr) {
+      completion->add_answers(answers_count);
+    }
+  }
+
+ private:
+  static constexpr std::size_t kDefaultBatchSize = 256;
+  // limits memory of submitted, but not applied operations
+  static constexpr std::size_t kMaxQueuedBatches = 64;
+
+ private:
+  PartitionT                            partition_;
+  std::size_t                           batch_size_;
+  std::vector<std::unique_ptr<shard_t>> shards_;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+// Fenwick (binary indexed) tree over positions [0, size()): point update and
+// prefix sum in O(log n), that are just loops over one contiguous array.
+template <typename CountT = std::size_t>
+class fenwick_tree_t {
+ public:
+  fenwick_tree_t() = default;
+
+  explicit fenwick_tree_t(std::size_t size)
+    : sums_(size + 1) {}
+
+  std::size_t size() const {
+    return sums_.empty() ? 0 : sums_.size() - 1;
+  }
+
+  // adds delta to value at position
+  void add(std::size_t position, CountT delta) {
+    assert(position < size());
+    for (std::size_t node_ind = position + 1; node_ind < sums_.size(); node_ind += lowest_bit(node_ind)) {
+      sums_[node_ind] += delta;
+    }
+  }
+
+  // sum of values at positions [0, end)
+  CountT prefix_sum(std::size_t end) const {
+    assert(end <= size());
+    CountT sum{};
+    for (std::size_t node_ind = end; node_ind != 0; node_ind -= lowest_bit(node_ind)) {
+      sum += sums_[node_ind];
+    }
+
+    return sum;
+  }
+
+  // sum of values at positions [begin, end)
+  CountT range_sum(std::size_t begin, std::size_t end) const {
+    return begin < end ? prefix_sum(end) - prefix_sum(begin) : CountT{};
+  }
+
+ private:
+  static std::size_t lowest_bit(std::size_t node_ind) {
+    return node_ind & (~node_ind + 1);
+  }
+
+ private:
+  // 1-indexed, sums_[i] holds sum over (i - lowest_bit(i), i]
+  std::vector<CountT> sums_;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Binary encoding of query stream, it is detected by input_reader_t automatically.
+// All numbers are little endian.
+//   offset 0: magic "AVLQ"
+//   offset 4: uint8  format version
+//   offset 5: uint8  key kind, see binary_key_kind_t
+//   offset 6: uint8  key width in bytes: 1, 2, 4 or 8
+//   offset 7: uint8  reserved, always 0
+//   offset 8: uint64 number of queries
+// Header is followed by queries without any separators: opcode byte, that is the same
+// as query symbol in text format ('k', 'd' or 'q'), and one ('k', 'd') or two ('q') keys,
+// each of them takes key width bytes. Converter from text format:
+// tests/tests_generators/convert_to_binary.py
+namespace solution::binary_query_log {
+
+enum class binary_key_kind_t : std::uint8_t {
+  kSigned   = 0,
+  kUnsigned = 1
+};
+
+inline constexpr std::string_view kMagic      = "AVLQ";
+inline constexpr std::uint8_t     kVersion    = 1;
+inline constexpr std::size_t      kHeaderSize = 16;
+
+inline constexpr std::size_t kVersionOffset    = 4;
+inline constexpr std::size_t kKeyKindOffset    = 5;
+inline constexpr std::size_t kKeyWidthOffset   = 6;
+inline constexpr std::size_t kQueryCountOffset = 8;
+
+inline constexpr bool is_valid_key_width(std::size_t key_width) {
+  return key_width == 1 || key_width == 2 || key_width == 4 || key_width == 8;
+}
+
+// reads little endian unsigned number of given width
+inline std::uint64_t load_little_endian(const char* bytes, std::size_t width) {
+  std::uint64_t value = 0;
+  for (std::size_t byte_ind = 0; byte_ind < width; ++byte_ind) {
+    value |= std::uint64_t{static_cast<unsigned char>(bytes[byte_ind])} << (8 * byte_ind);
+  }
+
+  return value;
+}
+
+}  // namespace solution::binary_query_log
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "AVL/utilities.hpp"
+#include "fenwick/fenwick_tree.hpp"
+#include "solutions/offline_queries.hpp"
+#include "solutions/solutions_impl.hpp"
+
+namespace solution {
+
+// Offline solution: whole query stream is read first, keys of 'k' and 'd' queries
+// are compressed into indices of sorted unique array, then queries are answered
+// in one pass with Fenwick tree over these indices. Answers are the same as
+// for online solutions, including duplicate inserts and erases of absent keys.
+// ContainerT is Fenwick tree type, e.g. fenwick_tree_t<>
+template <typename ContainerT, typename KeyT>
+class solution_t<ContainerT, KeyT, fenwick_solution_tag> {
+ private:
+  using query_t       = offline_query_t<KeyT>;
+  using query_types_t = offline_query_type_t;
+
+ public:
+  solution_t() = default;
+
+  // queries are read from mapped file, or from stdin if input_file_path is nullptr
+  explicit solution_t(const char* input_file_path)
+    : input_(input_file_path) {}
+
+  // false if input file couldn't be opened
+  [[nodiscard]] bool is_input_ok() const {
+    return !input_.fail();
+  }
+
+  // number of queries, that were read by solve()
+  [[nodiscard]] std::size_t queries_count() const {
+    return queries_.size();
+  }
+
+  void solve() {
+    queries_ = read_offline_queries<KeyT>(input_);
+    compress_keys();
+
+    container_ = ContainerT(keys_.size());
+    is_present_.assign(keys_.size(), false);
+    for (const query_t& query : queries_) {
+      switch (query.type) {
+        case query_types_t::kInsert:
+          update_key(query.low_key, true);
+          break;
+        case query_types_t::kErase:
+          update_key(query.low_key, false);
+          break;
+        case query_types_t::kQuery:
+          answer_query(query.low_key, query.high_key);
+          break;
+        default:
+          break;
+      }
+    }
+
+    output_.flush();
+  }
+
+ private:
+  void compress_keys() {
+    for (const query_t& query : queries_) {
+      if (query.type != query_types_t::kQuery) {
+        keys_.push_back(query.low_key);
+      }
+    }
+
+    std::sort(keys_.begin(), keys_.end());
+    keys_.erase(std::unique(keys_.begin(), keys_.end()), keys_.end());
+  }
+
+  void update_key(const KeyT& key, bool should_be_present) {
+    std::size_t key_ind = std::lower_bound(keys_.begin(), keys_.end(), key) - keys_.begin();
+    if (is_present_[key_ind] == should_be_present) {
+      return; // duplicate insert or erase of absent key
+    }
+
+    is_present_[key_ind] = should_be_present;
+    // unsigned counters wrap around on decrement, but range sums stay exact
+    container_.add(key_ind, should_be_present ? 1 : -1);
+  }
+
+  void answer_query(const KeyT& low_key, const KeyT& high_key) {
+    std::size_t dist = 0;
+    if (!(high_key < low_key)) {
+      std::size_t begin = std::lower_bound(keys_.begin(), keys_.end(), low_key)  - keys_.begin();
+      std::size_t end   = std::upper_bound(keys_.begin(), keys_.end(), high_key) - keys_.begin();
+      dist = container_.range_sum(begin, end);
+    }
+
+#ifndef TIME_MEASUREMENT_
+    output_.write(dist);
+#else
+    // I don't want compiler to optimize away computation of range sum
+    do_not_optimize(dist);
+#endif
+  }
+
+ private:
+  ContainerT           container_;
+  input_reader_t       input_;
+  output_writer_t      output_;
+  std::vector<query_t> queries_;
+  std::vector<KeyT>    keys_;       // sorted unique keys of 'k' and 'd' queries
+  std::vector<bool>    is_present_; // indexed as keys_
+};
+
+}  // namespace solution
@@ -0,0 +1,312 @@
+#pragma once
+
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "solutions/binary_query_log.hpp"
+
+namespace solution {
+
+// Tokenizer for query stream: input is read by big blocks straight from file descriptor
+// with read(2) and numbers are parsed in place with std::from_chars, so there are no
+// stream sentries, locales and per token copies like in std::cin >> number.
+// Regular files are mapped into memory instead and parsed without any copies at all.
+// Input, that starts with binary query log header (see binary_query_log.hpp), is decoded
+// as binary: read() returns the same opcodes and keys as for text format.
+class input_reader_t {
+ public:
+  explicit input_reader_t(int fd = STDIN_FILENO) {
+    init_stream(fd);
+    detect_binary_format();
+  }
+
+  // nullptr stands for stdin, files that can't be mapped (e.g. pipes) are read as stream
+  explicit input_reader_t(const char* file_path) {
+    if (file_path == nullptr) {
+      init_stream(STDIN_FILENO);
+      detect_binary_format();
+      return;
+    }
+
+    int fd = ::open(file_path, O_RDONLY);
+    if (fd < 0) {
+      std::cerr << kFileOpenFailErrMsg << " " << file_path << "\n";
+      is_eof_    = true;
+      is_failed_ = true;
+      return;
+    }
+
+    struct stat file_stat{};
+    if (::fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0) {
+      const std::size_t file_size = static_cast<std::size_t>(file_stat.st_size);
+      void* mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapping != MAP_FAILED) {
+        ::madvise(mapping, file_size, MADV_SEQUENTIAL);
+        ::close(fd);
+        mapping_size_ = file_size;
+        data_         = static_cast<const char*>(mapping);
+        end_          = file_size;
+        is_eof_       = true; // whole input is already available
+        detect_binary_format();
+        return;
+      }
+    }
+
+    init_stream(fd);
+    owns_fd_ = true;
+    detect_binary_format();
+  }
+
+  input_reader_t(const input_reader_t&) = delete;
+  input_reader_t& operator=(const input_reader_t&) = delete;
+
+  ~input_reader_t() {
+    if (mapping_size_ != 0) {
+      ::munmap(const_cast<char*>(data_), mapping_size_);
+    }
+    if (owns_fd_) {
+      ::close(fd_);
+    }
+  }
+
+  // reads single non whitespace character, false at the end of input
+  bool read(char& symbol) {
+    if (is_binary_) {
+      if (!ensure_available(1)) {
+        return false;
+      }
+
+      symbol = data_[begin_++];
+      return true;
+    }
+
+    if (!skip_whitespace()) {
+      return false;
+    }
+
+    symbol = data_[begin_++];
+    return true;
+  }
+
+  template <typename T>
+  bool read(T& number) {
+    static_assert(std::is_arithmetic_v<T>, "only numbers can be parsed by input_reader_t");
+    if (is_binary_) {
+      return read_binary_key(number);
+    }
+
+    if (!skip_whitespace()) {
+      return false;
+    }
+
+    // whole number has to be in the buffer, it must not be cut by the end of block
+    ensure_available(kMaxNumberLength);
+
+    const char* first = data_ + begin_;
+    const char* last  = data_ + end_;
+    if (*first == '+') {
+      ++first; // operator>> accepts explicit plus sign, from_chars doesn't
+    }
+
+    auto [number_end, error] = std::from_chars(first, last, number);
+    if (error != std::errc{}) {
+      is_failed_ = true;
+      return false;
+    }
+
+    begin_ = static_cast<std::size_t>(number_end - data_);
+    return true;
+  }
+
+  // true if last read failed because of end of input
+  bool eof() const { return is_eof_ && begin_ == end_; }
+
+  // true if last read failed because of malformed token
+  bool fail() const { return is_failed_; }
+
+  bool is_binary() const { return is_binary_; }
+
+  // number of queries from binary header, 0 for text input
+  std::uint64_t binary_query_count() const { return binary_query_count_; }
+
+ private:
+  void init_stream(int fd) {
+    fd_ = fd;
+    buffer_.resize(kBlockSize);
+    data_ = buffer_.data();
+  }
+
+  void detect_binary_format() {
+    namespace log = binary_query_log;
+    ensure_available(log::kHeaderSize);
+    if (end_ - begin_ < log::kMagic.size() ||
+        std::string_view(data_ + begin_, log::kMagic.size()) != log::kMagic) {
+      return; // text input
+    }
+
+    const char* header = data_ + begin_;
+    const auto key_kind  = static_cast<log::binary_key_kind_t>(header[log::kKeyKindOffset]);
+    const auto key_width = static_cast<std::size_t>(header[log::kKeyWidthOffset]);
+    if (end_ - begin_ < log::kHeaderSize ||
+        static_cast<std::uint8_t>(header[log::kVersionOffset]) != log::kVersion ||
+        (key_kind != log::binary_key_kind_t::kSigned &&
+         key_kind != log::binary_key_kind_t::kUnsigned) ||
+        !log::is_valid_key_width(key_width)) {
+      std::cerr << kBadBinaryHeaderErrMsg << "\n";
+      is_eof_    = true;
+      is_failed_ = true;
+      begin_     = end_;
+      return;
+    }
+
+    is_binary_          = true;
+    is_key_signed_      = key_kind == log::binary_key_kind_t::kSigned;
+    key_width_          = key_width;
+    binary_query_count_ = log::load_little_endian(header + log::kQueryCountOffset, 8);
+    begin_ += log::kHeaderSize;
+  }
+
+  template <typename T>
+  bool read_binary_key(T& number) {
+    if (!ensure_available(key_width_)) {
+      is_failed_ = begin_ != end_; // key is cut by the end of input
+      return false;
+    }
+
+    std::uint64_t bits = binary_query_log::load_little_endian(data_ + begin_, key_width_);
+    begin_ += key_width_;
+
+    // key has to be representable by T, like in operator>>
+    bool is_in_range = true;
+    if (is_key_signed_) {
+      const int unused_bits = 64 - 8 * static_cast<int>(key_width_);
+      const std::int64_t value = static_cast<std::int64_t>(bits << unused_bits) >> unused_bits;
+      number = static_cast<T>(value);
+      is_in_range = static_cast<std::int64_t>(number) == value;
+      if constexpr (std::is_unsigned_v<T>) {
+        is_in_range = is_in_range && value >= 0;
+      }
+    } else {
+      number = static_cast<T>(bits);
+      is_in_range = static_cast<std::uint64_t>(number) == bits;
+      if constexpr (std::is_signed_v<T>) {
+        is_in_range = is_in_range && number >= T{};
+      }
+    }
+
+    if (!is_in_range) {
+      is_failed_ = true;
+      return false;
+    }
+    return true;
+  }
+
+  // refills buffer until it has at least size unread bytes or input ends
+  bool ensure_available(std::size_t size) {
+    while (end_ - begin_ < size) {
+      if (!refill()) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  static bool is_whitespace(char symbol) {
+    return symbol == ' '  || symbol == '\n' || symbol == '\t' ||
+           symbol == '\r' || symbol == '\v' || symbol == '\f';
+  }
+
+  bool skip_whitespace() {
+    while (true) {
+      while (begin_ < end_ && is_whitespace(data_[begin_])) {
+        ++begin_;
+      }
+      if (begin_ < end_) {
+        return true;
+      }
+      if (!refill()) {
+        return false;
+      }
+    }
+  }
+
+  // moves unread tail to the start of buffer and appends next block after it,
+  // returns false if nothing was appended
+  bool refill() {
+    if (is_eof_) {
+      return false;
+    }
+
+    const std::size_t unread_size = end_ - begin_;
+    std::memmove(buffer_.data(), buffer_.data() + begin_, unread_size);
+    begin_ = 0;
+    end_   = unread_size;
+
+    while (true) {
+      ssize_t read_size = ::read(fd_, buffer_.data() + end_, buffer_.size() - end_);
+      if (read_size > 0) {
+        end_ += static_cast<std::size_t>(read_size);
+        return true;
+      }
+      if (read_size < 0 && errno == EINTR) {
+        continue;
+      }
+
+      // read error is treated the same way as end of input
+      is_eof_ = true;
+      return false;
+    }
+  }
+
+ private:
+  static constexpr std::string_view kFileOpenFailErrMsg    = "Error: can't open input file";
+  static constexpr std::string_view kBadBinaryHeaderErrMsg = "Error: unsupported binary query log header...";
+
+ private:
+  static constexpr std::size_t kBlockSize       = 1 << 20;
+  // longest integer or floating point number that is parsed as a whole
+  static constexpr std::size_t kMaxNumberLength = 64;
+
+ private:
+  int               fd_ = -1;
+  bool              owns_fd_{};
+  std::vector<char> buffer_;
+  const char*       data_ = nullptr; // either buffer_ or mapped file
+  std::size_t       mapping_size_{};
+  std::size_t       begin_{};
+  std::size_t       end_{};
+  bool              is_eof_{};
+  bool              is_failed_{};
+  // binary format
+  bool              is_binary_{};
+  bool              is_key_signed_{};
+  std::size_t       key_width_{};
+  std::uint64_t     binary_query_count_{};
+};
+
+// returns path after --input flag, or nullptr if queries have to be read from stdin
+inline const char* find_input_file_path(int argc, char* argv[]) {
+  for (int arg_ind = 1; arg_ind + 1 < argc; ++arg_ind) {
+    if (std::string_view(argv[arg_ind]) == "--input") {
+      return argv[arg_ind + 1];
+    }
+  }
+
+  return nullptr;
+}
+
+}  // namespace solution
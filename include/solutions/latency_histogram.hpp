@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <utility>
+
+namespace solution {
+
+// HDR style histogram: values below kSubBucketsCount are counted exactly, every further power
+// of two range is split into kSubBucketsCount equal buckets, so percentiles have relative error
+// below 1 / kSubBucketsCount at any magnitude. record() is a few arithmetic instructions and
+// one increment, memory is fixed (~8 KB), there are no allocations.
+class latency_histogram_t {
+ private:
+  static constexpr std::size_t kSubBucketsBits  = 4;
+  static constexpr std::size_t kSubBucketsCount = std::size_t{1} << kSubBucketsBits;
+  static constexpr std::size_t kValueBits       = 64;
+  static constexpr std::size_t kBucketsCount    = kSubBucketsCount * (kValueBits - kSubBucketsBits + 1);
+
+ public:
+  void record(std::uint64_t value) {
+    ++buckets_[get_bucket_ind(value)];
+    ++count_;
+    max_value_ = std::max(max_value_, value);
+  }
+
+  std::uint64_t count() const { return count_; }
+
+  std::uint64_t max() const { return max_value_; }
+
+  // the largest value, that is equivalent to value at given percentile (0 ... 100),
+  // 0 if histogram is empty
+  std::uint64_t percentile(double percent) const {
+    if (count_ == 0) {
+      return 0;
+    }
+
+    const double clamped_percent = std::clamp(percent, 0.0, 100.0);
+    std::uint64_t rank = static_cast<std::uint64_t>(clamped_percent / 100.0 * count_ + 0.5);
+    rank = std::clamp<std::uint64_t>(rank, 1, count_);
+
+    std::uint64_t seen_count = 0;
+    for (std::size_t bucket_ind = 0; bucket_ind < kBucketsCount; ++bucket_ind) {
+      seen_count += buckets_[bucket_ind];
+      if (seen_count >= rank) {
+        return std::min(get_bucket_max_value(bucket_ind), max_value_);
+      }
+    }
+
+    return max_value_;
+  }
+
+  // single JSON object: count, max and p50, p90, p99, p99.9, p99.99
+  void print_json(std::ostream& out) const {
+    out << "{\"count\": " << count_ << ", \"max\": " << max_value_;
+    for (const auto& [name, percent] : kReportedPercentiles) {
+      out << ", \"" << name << "\": " << percentile(percent);
+    }
+    out << "}";
+  }
+
+ private:
+  static std::size_t get_bucket_ind(std::uint64_t value) {
+    if (value < kSubBucketsCount) {
+      return static_cast<std::size_t>(value);
+    }
+
+    const std::size_t msb = kValueBits - 1 - __builtin_clzll(value);
+    const std::size_t shift = msb - kSubBucketsBits;
+    const std::size_t sub_bucket_ind = static_cast<std::size_t>(value >> shift) & (kSubBucketsCount - 1);
+    return kSubBucketsCount * (shift + 1) + sub_bucket_ind;
+  }
+
+  static std::uint64_t get_bucket_max_value(std::size_t bucket_ind) {
+    if (bucket_ind < kSubBucketsCount) {
+      return bucket_ind;
+    }
+
+    const std::size_t shift = bucket_ind / kSubBucketsCount - 1;
+    const std::uint64_t sub_bucket_ind = bucket_ind % kSubBucketsCount;
+    const std::uint64_t min_value = (kSubBucketsCount + sub_bucket_ind) << shift;
+    return min_value + ((std::uint64_t{1} << shift) - 1);
+  }
+
+ private:
+  static constexpr std::pair<std::string_view, double> kReportedPercentiles[] = {
+    {"p50", 50.0}, {"p90", 90.0}, {"p99", 99.0}, {"p999", 99.9}, {"p9999", 99.99}
+  };
+
+ private:
+  std::array<std::uint64_t, kBucketsCount> buckets_{};
+  std::uint64_t count_{};
+  std::uint64_t max_value_{};
+};
+
+}  // namespace solution
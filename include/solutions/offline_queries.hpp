@@ -0,0 +1,61 @@
+#pragma once
+
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include "solutions/input_reader.hpp"
+
+// Query log, that is read as a whole by offline solutions before answering anything
+namespace solution {
+
+enum class offline_query_type_t : char {
+  kInsert = 'k',
+  kErase  = 'd',
+  kQuery  = 'q'
+};
+
+template <typename KeyT>
+struct offline_query_t {
+  offline_query_type_t type;
+  KeyT                 low_key;  // the only key of 'k' and 'd' queries
+  KeyT                 high_key; // only for range queries
+};
+
+// reads queries until the end of input or first malformed query, like online solutions
+template <typename KeyT>
+std::vector<offline_query_t<KeyT>> read_offline_queries(input_reader_t& input) {
+  static constexpr std::string_view kUnknownQueryType = "Error: unknown query type...";
+
+  std::vector<offline_query_t<KeyT>> queries;
+  if (input.is_binary()) {
+    queries.reserve(input.binary_query_count());
+  }
+
+  char query_type_ch{};
+  while (input.read(query_type_ch)) {
+    offline_query_t<KeyT> query{static_cast<offline_query_type_t>(query_type_ch), KeyT{}, KeyT{}};
+    bool success_read = false;
+    switch (query.type) {
+      case offline_query_type_t::kInsert:
+      case offline_query_type_t::kErase:
+        success_read = input.read(query.low_key);
+        break;
+      case offline_query_type_t::kQuery:
+        success_read = input.read(query.low_key) && input.read(query.high_key);
+        break;
+      default:
+        std::cerr << kUnknownQueryType << "\n";
+        break;
+    }
+    if (!success_read) {
+      break;
+    }
+
+    queries.push_back(query);
+  }
+
+  return queries;
+}
+
+}  // namespace solution
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include <unistd.h>
+
+namespace solution {
+
+// Answers are formatted with std::to_chars into one reusable buffer, that is
+// flushed to file descriptor with write(2) only when it is almost full, so there
+// is no stream sentry and locale aware formatting per answer like in std::cout << number.
+class output_writer_t {
+ public:
+  explicit output_writer_t(int fd = STDOUT_FILENO)
+    : fd_(fd), buffer_(kBufferSize) {}
+
+  output_writer_t(const output_writer_t&) = delete;
+  output_writer_t& operator=(const output_writer_t&) = delete;
+
+  ~output_writer_t() { flush(); }
+
+  // writes number followed by separator
+  template <typename T>
+  void write(T number, char separator = ' ') {
+    static_assert(std::is_integral_v<T>, "only integers can be written by output_writer_t");
+    if (buffer_.size() - size_ < kMaxNumberLength + 1) {
+      flush();
+    }
+
+    char* const buffer_end = buffer_.data() + buffer_.size();
+    auto [number_end, error] = std::to_chars(buffer_.data() + size_, buffer_end, number);
+    (void)error; // there is always enough space for any integer
+    // always true after flush above, but compiler can't prove it for separator
+    if (number_end < buffer_end) {
+      *number_end++ = separator;
+    }
+    size_ = static_cast<std::size_t>(number_end - buffer_.data());
+  }
+
+  // writes bytes as they are, e.g. query symbols or binary encoded numbers
+  void write_raw(const char* data, std::size_t data_size) {
+    while (data_size != 0) {
+      if (size_ == buffer_.size()) {
+        flush();
+      }
+
+      const std::size_t chunk_size = std::min(data_size, buffer_.size() - size_);
+      std::memcpy(buffer_.data() + size_, data, chunk_size);
+      size_     += chunk_size;
+      data      += chunk_size;
+      data_size -= chunk_size;
+    }
+  }
+
+  void flush() {
+    std::size_t written_size = 0;
+    while (written_size < size_) {
+      ssize_t result = ::write(fd_, buffer_.data() + written_size, size_ - written_size);
+      if (result < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        break; // nobody to report to, output is lost anyway
+      }
+      written_size += static_cast<std::size_t>(result);
+    }
+
+    size_ = 0;
+  }
+
+ private:
+  static constexpr std::size_t kBufferSize      = 1 << 16;
+  // 64-bit integer takes at most 20 digits and sign
+  static constexpr std::size_t kMaxNumberLength = 21;
+
+ private:
+  int               fd_;
+  std::vector<char> buffer_;
+  std::size_t       size_{};
+};
+
+}  // namespace solution
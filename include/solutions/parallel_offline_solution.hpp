@@ -0,0 +1,384 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "AVL/utilities.hpp"
+#include "solutions/offline_queries.hpp"
+#include "solutions/solutions_impl.hpp"
+
+namespace solution {
+
+// Parallel offline solution, divide and conquer over time. Query log is cut into time blocks.
+//   1. for every block its effect is computed in parallel: for each touched key,
+//      whether it is present after the block (the last 'k' or 'd' of the key wins)
+//   2. blocks are processed by waves of threads_count blocks. Wave shares one base
+//      (sorted array of keys present before the wave), state before every block of the
+//      wave is base plus combined effect of previous blocks of the wave. Combined effects
+//      are built by parallel prefix scan over sorted effects (log2(threads_count) rounds
+//      of merges), so there is no copy of base per block
+//   3. blocks are answered in parallel: count of keys in base (two binary searches),
+//      corrected by keys, that previous blocks of the wave added or removed, and by
+//      keys, that were added or removed earlier in the same block, they are kept in
+//      two ContainerT trees
+//   4. base of the next wave is merged from base and effect of the whole wave,
+//      chunks of base are merged in parallel
+// ContainerT is tree with count_range(), e.g. compact_AVL_tree_t<KeyT>
+template <typename ContainerT, typename KeyT>
+class solution_t<ContainerT, KeyT, parallel_offline_solution_tag> {
+ private:
+  using query_t       = offline_query_t<KeyT>;
+  using query_types_t = offline_query_type_t;
+
+  // keys touched by block, sorted, with their presence after block
+  using block_effect_t = std::vector<std::pair<KeyT, bool>>;
+
+  struct block_t {
+    std::size_t begin;
+    std::size_t end;
+  };
+
+  // keys present before block: base of wave with keys, that previous blocks of wave
+  // added to it or removed from it
+  struct block_state_t {
+    const std::vector<KeyT>& base;
+    std::vector<KeyT>        added_keys;
+    std::vector<KeyT>        removed_keys;
+
+    bool contains(const KeyT& key) const {
+      return std::binary_search(added_keys.begin(), added_keys.end(), key) ||
+             (std::binary_search(base.begin(), base.end(), key) &&
+              !std::binary_search(removed_keys.begin(), removed_keys.end(), key));
+    }
+
+    std::size_t count_range(const KeyT& low_key, const KeyT& high_key) const {
+      return count_sorted(base, low_key, high_key) + count_sorted(added_keys, low_key, high_key)
+                                                   - count_sorted(removed_keys, low_key, high_key);
+    }
+  };
+
+ public:
+  // queries are read from mapped file, or from stdin if input_file_path is nullptr
+  explicit solution_t(const char* input_file_path = nullptr, std::size_t threads_count = 1)
+    : input_(input_file_path), threads_count_(std::max<std::size_t>(threads_count, 1)) {}
+
+  // false if input file couldn't be opened
+  [[nodiscard]] bool is_input_ok() const {
+    return !input_.fail();
+  }
+
+  // number of queries, that were read by solve()
+  [[nodiscard]] std::size_t queries_count() const {
+    return queries_.size();
+  }
+
+  void solve() {
+    queries_ = read_offline_queries<KeyT>(input_);
+    split_into_blocks();
+
+    std::vector<block_effect_t> effects(blocks_.size());
+    parallel_for(blocks_.size(), [&](std::size_t block_ind) {
+      effects[block_ind] = compute_block_effect(blocks_[block_ind]);
+    });
+
+    std::vector<KeyT> base;
+    std::vector<std::vector<std::size_t>> wave_answers(threads_count_);
+    for (std::size_t wave_begin = 0; wave_begin < blocks_.size(); wave_begin += threads_count_) {
+      const std::size_t wave_size = std::min(threads_count_, blocks_.size() - wave_begin);
+      // combined_effects[i] is effect of blocks wave_begin ... wave_begin + i
+      std::vector<block_effect_t> combined_effects = combine_effects_prefixes(
+        std::make_move_iterator(effects.begin() + wave_begin),
+        std::make_move_iterator(effects.begin() + wave_begin + wave_size)
+      );
+
+      parallel_for(wave_size, [&](std::size_t wave_ind) {
+        static const block_effect_t kNoEffect;
+        const block_state_t state = get_block_state(
+          base, wave_ind == 0 ? kNoEffect : combined_effects[wave_ind - 1]
+        );
+        wave_answers[wave_ind] = answer_block(blocks_[wave_begin + wave_ind], state);
+      });
+
+      if (wave_begin + wave_size < blocks_.size()) {
+        base = apply_effect(base, combined_effects[wave_size - 1]);
+      }
+
+      for (std::size_t wave_ind = 0; wave_ind < wave_size; ++wave_ind) {
+        write_answers(wave_answers[wave_ind]);
+      }
+    }
+
+    output_.flush();
+  }
+
+ private:
+  void split_into_blocks() {
+    // single thread gets single block, so there are no merges of effects at all
+    const std::size_t max_blocks_count = std::max<std::size_t>(1, queries_.size() / kMinBlockSize);
+    std::size_t blocks_count = 1;
+    if (threads_count_ > 1) {
+      blocks_count = threads_count_ > max_blocks_count / kBlocksPerThread ? max_blocks_count
+                                                                          : threads_count_ * kBlocksPerThread;
+    }
+
+    const std::size_t block_size = (queries_.size() + blocks_count - 1) / blocks_count;
+    blocks_.clear();
+    for (std::size_t begin = 0; begin < queries_.size(); begin += block_size) {
+      blocks_.push_back({begin, std::min(begin + block_size, queries_.size())});
+    }
+    // extra threads would have no blocks to answer
+    threads_count_ = std::max<std::size_t>(1, std::min(threads_count_, blocks_.size()));
+  }
+
+  template <typename FuncT>
+  void parallel_for(std::size_t tasks_count, FuncT func) const {
+    std::atomic<std::size_t> next_task{0};
+    auto worker = [&]() {
+      for (std::size_t task = next_task++; task < tasks_count; task = next_task++) {
+        func(task);
+      }
+    };
+
+    std::vector<std::thread> threads;
+    const std::size_t threads_count = std::min(threads_count_, tasks_count);
+    for (std::size_t thread_ind = 1; thread_ind < threads_count; ++thread_ind) {
+      threads.emplace_back(worker);
+    }
+    worker(); // current thread works too
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  }
+
+  block_effect_t compute_block_effect(const block_t& block) const {
+    block_effect_t effect;
+    for (std::size_t query_ind = block.begin; query_ind < block.end; ++query_ind) {
+      const query_t& query = queries_[query_ind];
+      if (query.type != query_types_t::kQuery) {
+        effect.emplace_back(query.low_key, query.type == query_types_t::kInsert);
+      }
+    }
+
+    // stable sort keeps updates of each key in time order, so the last one is kept
+    std::stable_sort(effect.begin(), effect.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.first < rhs.first;
+    });
+    auto last_updates_end = std::unique(effect.rbegin(), effect.rend(), [](const auto& lhs, const auto& rhs) {
+      return !(lhs.first < rhs.first) && !(rhs.first < lhs.first);
+    });
+    effect.erase(effect.begin(), last_updates_end.base());
+
+    return effect;
+  }
+
+  // effect of older block followed by newer block, newer update of key wins
+  static block_effect_t merge_effects(const block_effect_t& older, const block_effect_t& newer) {
+    block_effect_t merged;
+    merged.reserve(older.size() + newer.size());
+
+    std::size_t older_ind = 0;
+    for (const auto& update : newer) {
+      while (older_ind < older.size() && older[older_ind].first < update.first) {
+        merged.push_back(older[older_ind++]);
+      }
+      if (older_ind < older.size() && !(update.first < older[older_ind].first)) {
+        ++older_ind; // newer update of the same key
+      }
+      merged.push_back(update);
+    }
+    merged.insert(merged.end(), older.begin() + older_ind, older.end());
+
+    return merged;
+  }
+
+  // inclusive prefix scan of effects by merge_effects(), Hillis-Steele: in round with
+  // given step every prefix is merged with prefix, that ends step blocks earlier
+  template <typename EffectsIterT>
+  std::vector<block_effect_t> combine_effects_prefixes(EffectsIterT first, EffectsIterT last) const {
+    std::vector<block_effect_t> prefixes(first, last);
+    std::vector<block_effect_t> next_prefixes(prefixes.size());
+    for (std::size_t step = 1; step < prefixes.size(); step *= 2) {
+      parallel_for(prefixes.size() - step, [&](std::size_t merge_ind) {
+        const std::size_t prefix_ind = merge_ind + step;
+        next_prefixes[prefix_ind] = merge_effects(prefixes[prefix_ind - step], prefixes[prefix_ind]);
+      });
+      // the first step prefixes are complete, they are read by merges above, so moved only now
+      std::move(prefixes.begin(), prefixes.begin() + step, next_prefixes.begin());
+      std::swap(prefixes, next_prefixes);
+    }
+
+    return prefixes;
+  }
+
+  static block_state_t get_block_state(const std::vector<KeyT>& base, const block_effect_t& effect) {
+    block_state_t state{base, {}, {}};
+    for (const auto& [key, is_present] : effect) {
+      if (is_present != std::binary_search(base.begin(), base.end(), key)) {
+        (is_present ? state.added_keys : state.removed_keys).push_back(key);
+      }
+    }
+
+    return state;
+  }
+
+  // keys of base changed by effect, base is split into chunks, that are merged in parallel
+  std::vector<KeyT> apply_effect(const std::vector<KeyT>& base, const block_effect_t& effect) const {
+    const std::size_t chunks_count = base.empty() ? 1 : std::min(threads_count_, base.size());
+    std::vector<std::vector<KeyT>> chunks(chunks_count);
+    parallel_for(chunks_count, [&](std::size_t chunk_ind) {
+      // chunk owns keys of base and effect from base[chunk_ind * size / count] to the next chunk
+      auto get_base_bound = [&](std::size_t ind) {
+        return ind * base.size() / chunks_count;
+      };
+      auto get_effect_bound = [&](std::size_t ind) -> std::size_t {
+        if (ind == 0 || ind == chunks_count) {
+          return ind == 0 ? 0 : effect.size();
+        }
+        auto effect_it = std::lower_bound(effect.begin(), effect.end(), base[get_base_bound(ind)],
+          [](const auto& update, const KeyT& key) { return update.first < key; });
+        return effect_it - effect.begin();
+      };
+      const std::size_t base_begin   = get_base_bound(chunk_ind);
+      const std::size_t base_end     = get_base_bound(chunk_ind + 1);
+      const std::size_t effect_begin = get_effect_bound(chunk_ind);
+      const std::size_t effect_end   = get_effect_bound(chunk_ind + 1);
+
+      std::vector<KeyT>& chunk = chunks[chunk_ind];
+      chunk.reserve(base_end - base_begin + effect_end - effect_begin);
+      std::size_t key_ind = base_begin;
+      for (std::size_t update_ind = effect_begin; update_ind < effect_end; ++update_ind) {
+        const auto& [key, is_present] = effect[update_ind];
+        while (key_ind < base_end && base[key_ind] < key) {
+          chunk.push_back(base[key_ind++]);
+        }
+        if (key_ind < base_end && !(key < base[key_ind])) {
+          ++key_ind; // key is in base, effect decides whether it stays
+        }
+        if (is_present) {
+          chunk.push_back(key);
+        }
+      }
+      chunk.insert(chunk.end(), base.begin() + key_ind, base.begin() + base_end);
+    });
+
+    std::vector<std::size_t> chunk_offsets(chunks_count + 1, 0);
+    for (std::size_t chunk_ind = 0; chunk_ind < chunks_count; ++chunk_ind) {
+      chunk_offsets[chunk_ind + 1] = chunk_offsets[chunk_ind] + chunks[chunk_ind].size();
+    }
+    std::vector<KeyT> next_base(chunk_offsets.back());
+    parallel_for(chunks_count, [&](std::size_t chunk_ind) {
+      std::copy(chunks[chunk_ind].begin(), chunks[chunk_ind].end(), next_base.begin() + chunk_offsets[chunk_ind]);
+    });
+
+    return next_base;
+  }
+
+  std::vector<std::size_t> answer_block(const block_t& block, const block_state_t& state) const {
+    ContainerT added_keys;   // present now, but not before block
+    ContainerT removed_keys; // present before block, but not now
+    std::vector<std::size_t> answers;
+
+    for (std::size_t query_ind = block.begin; query_ind < block.end; ++query_ind) {
+      const query_t& query = queries_[query_ind];
+      if (query.type == query_types_t::kQuery) {
+        answers.push_back(count_keys_in_range(state, added_keys, removed_keys,
+                                              query.low_key, query.high_key));
+        continue;
+      }
+
+      const bool was_present = state.contains(query.low_key);
+      if (query.type == query_types_t::kInsert) {
+        if (was_present) {
+          removed_keys.erase(query.low_key);
+        } else {
+          added_keys.insert(query.low_key);
+        }
+      } else {
+        if (was_present) {
+          removed_keys.insert(query.low_key);
+        } else {
+          added_keys.erase(query.low_key);
+        }
+      }
+    }
+
+    return answers;
+  }
+
+  static std::size_t count_keys_in_range(
+    const block_state_t& state,
+    const ContainerT&    added_keys,
+    const ContainerT&    removed_keys,
+    const KeyT& low_key, const KeyT& high_key
+  ) {
+    if (high_key < low_key) {
+      return 0;
+    }
+
+    return state.count_range(low_key, high_key) + added_keys.count_range(low_key, high_key)
+                                                - removed_keys.count_range(low_key, high_key);
+  }
+
+  static std::size_t count_sorted(const std::vector<KeyT>& keys, const KeyT& low_key, const KeyT& high_key) {
+    return std::upper_bound(keys.begin(), keys.end(), high_key) - std::lower_bound(keys.begin(), keys.end(), low_key);
+  }
+
+  void write_answers(const std::vector<std::size_t>& answers) {
+#ifndef TIME_MEASUREMENT_
+    for (std::size_t dist : answers) {
+      output_.write(dist);
+    }
+#else
+    // I don't want compiler to optimize away computation of answers
+    do_not_optimize(answers.data());
+#endif
+  }
+
+ private:
+  static constexpr std::size_t kBlocksPerThread = 4;
+  // smaller blocks don't pay off merges of their effects
+  static constexpr std::size_t kMinBlockSize    = 1 << 12;
+
+ private:
+  input_reader_t       input_;
+  output_writer_t      output_;
+  std::size_t          threads_count_;
+  std::vector<query_t> queries_;
+  std::vector<block_t> blocks_;
+};
+
+// returns number after --threads flag, capped by number of hardware threads. Without flag, or if
+// it isn't positive number, number of hardware threads is returned
+inline std::size_t find_threads_count(int argc, char* argv[]) {
+  const std::size_t hardware_threads_count = std::max(1u, std::thread::hardware_concurrency());
+  for (int arg_ind = 1; arg_ind + 1 < argc; ++arg_ind) {
+    if (std::string_view(argv[arg_ind]) != "--threads") {
+      continue;
+    }
+
+    const char* value = argv[arg_ind + 1];
+    char* value_end = nullptr;
+    errno = 0;
+    const long long threads_count = std::strtoll(value, &value_end, 10);
+    if (errno != 0 || value_end == value || *value_end != '\0' || threads_count <= 0) {
+      std::cerr << "Error: invalid number of threads '" << value << "', number of hardware threads ("
+                << hardware_threads_count << ") is used\n";
+      return hardware_threads_count;
+    }
+
+    return std::min(static_cast<std::size_t>(threads_count), hardware_threads_count);
+  }
+
+  return hardware_threads_count;
+}
+
+}  // namespace solution
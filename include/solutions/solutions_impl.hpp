@@ -1,15 +1,26 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <ostream>
 #include <set>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include "AVL/AVL_tree.hpp"
 #include "AVL/utilities.hpp"
+#include "solutions/input_reader.hpp"
+#include "solutions/latency_histogram.hpp"
+#include "solutions/output_writer.hpp"
 
 namespace solution {
 
 struct avl_solution_tag {};
 struct set_solution_tag {};
+struct fenwick_solution_tag {}; // offline, see fenwick_solution.hpp
+struct parallel_offline_solution_tag {}; // offline, see parallel_offline_solution.hpp
 
 template <typename ContainerT, typename KeyT, typename solution_tag>
 class solution_t {
@@ -19,6 +30,7 @@ class solution_t {
  private:
   enum class query_types_t {
     kInsert  = 'k',
+    kErase   = 'd',
     kQuery   = 'q',
     kInvalid = '?'
   };
@@ -26,6 +38,24 @@ class solution_t {
  public:
   solution_t() = default;
 
+  // queries are read from mapped file, or from stdin if input_file_path is nullptr
+  explicit solution_t(const char* input_file_path)
+    : input_(input_file_path) {}
+
+  // false if input file couldn't be opened
+  [[nodiscard]] bool is_input_ok() const {
+    return !input_.fail();
+  }
+
+  // number of queries, that were read by solve()
+  [[nodiscard]] std::size_t queries_count() const {
+    return query_index_;
+  }
+
+  [[nodiscard]] const ContainerT& container() const {
+    return container_;
+  }
+
   void solve() {
     char query_type_ch{};
     while (try_to_read(query_type_ch)) {
@@ -33,10 +63,22 @@ class solution_t {
       KeyT key{};
       bool success_read = false;
       query_types_t query_type = get_query_type(query_type_ch);
+      if (query_type != query_types_t::kQuery) {
+        // answers are written in order of queries and before container changes
+        flush_pending_queries();
+      }
+      if (query_type != query_types_t::kInsert) {
+        // keys must be in container before anything else looks at it
+        flush_pending_keys();
+      }
+
       switch (query_type) {
         case query_types_t::kInsert:
           success_read = insert_key();
           break;
+        case query_types_t::kErase:
+          success_read = erase_key();
+          break;
         case query_types_t::kQuery:
           success_read = process_query();
           break;
@@ -50,59 +92,164 @@ class solution_t {
         break;
       }
     }
-    std::cout.flush(); // just in case
+    flush_pending_queries();
+    flush_pending_keys();
+    output_.flush();
   }
 
+#ifdef LATENCY_HISTOGRAMS_
+  // single JSON object with latencies of 'k' and 'q' queries in nanoseconds and height of
+  // container at the moment of these queries (null for containers without height)
+  void print_latency_report(std::ostream& out) const {
+    out << "{\"insert_latency_ns\": ";
+    insert_latencies_.print_json(out);
+    out << ", \"query_latency_ns\": ";
+    query_latencies_.print_json(out);
+    out << ", \"height\": ";
+    if (heights_.count() != 0) {
+      heights_.print_json(out);
+    } else {
+      out << "null";
+    }
+    out << "}" << std::endl;
+  }
+#endif
+
  private:
-  [[nodiscard]] static std::size_t get_my_distance_impl(
-    const_iterator start, const_iterator finish, avl_solution_tag
-  ) {
-    return finish - start;
+  void count_pending_queries_impl(avl_solution_tag) {
+    container_.count_range_batch(pending_queries_.begin(), pending_queries_.end(),
+                                 std::back_inserter(pending_answers_));
+  }
+
+  void count_pending_queries_impl(set_solution_tag) {
+    for (const auto& [low_key, high_key] : pending_queries_) {
+      pending_answers_.push_back(count_query_impl(set_solution_tag{}, low_key, high_key));
+    }
+  }
+
+  std::size_t count_query_impl(avl_solution_tag, const KeyT& low_key, const KeyT& high_key) const {
+    return container_.count_range(low_key, high_key);
+  }
+
+  std::size_t count_query_impl(set_solution_tag, const KeyT& low_key, const KeyT& high_key) const {
+    const_iterator start = container_.lower_bound(low_key);
+    const_iterator fin   = container_.upper_bound(high_key);
+    return std::distance(start, fin);
+  }
+
+  void record_height_impl(avl_solution_tag) {
+#ifdef LATENCY_HISTOGRAMS_
+    heights_.record(container_.height());
+#endif
+  }
+
+  void record_height_impl(set_solution_tag) {}
+
+#ifdef LATENCY_HISTOGRAMS_
+  // latency of func is recorded into histogram of query_type
+  template <typename FuncT>
+  void run_measured(query_types_t query_type, FuncT func) {
+    auto start_time = std::chrono::steady_clock::now();
+    func();
+    auto finish_time = std::chrono::steady_clock::now();
+
+    const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(finish_time - start_time);
+    auto& latencies = query_type == query_types_t::kInsert ? insert_latencies_ : query_latencies_;
+    latencies.record(static_cast<std::uint64_t>(latency.count()));
+    record_height_impl(solution_tag{});
+  }
+#endif
+
+  void write_answer(std::size_t dist) {
+#ifndef TIME_MEASUREMENT_
+    output_.write(dist);
+#else
+    // I don't want compiler to optimize away computation of answers
+    do_not_optimize(dist);
+#endif
+  }
+
+  // consecutive 'q' queries are independent, so they are answered as one batch
+  void flush_pending_queries() {
+    if (pending_queries_.empty()) {
+      return;
+    }
+
+    count_pending_queries_impl(solution_tag{});
+    for (std::size_t dist : pending_answers_) {
+      write_answer(dist);
+    }
+    pending_queries_.clear();
+    pending_answers_.clear();
+  }
+
+  void insert_pending_keys_impl(avl_solution_tag) {
+    // pending keys are sorted in place in order of tree, so tree doesn't copy them
+    const auto comparator = container_.key_comp();
+    auto are_equal = [&comparator](const KeyT& lhs, const KeyT& rhs) {
+      return !comparator(lhs, rhs) && !comparator(rhs, lhs);
+    };
+    std::sort(pending_keys_.begin(), pending_keys_.end(), comparator);
+    pending_keys_.erase(std::unique(pending_keys_.begin(), pending_keys_.end(), are_equal), pending_keys_.end());
+    container_.insert_sorted_batch(pending_keys_.begin(), pending_keys_.end());
   }
 
-  [[nodiscard]] static std::size_t get_my_distance_impl(
-    const_iterator start, const_iterator finish, set_solution_tag
-  ) {
-    return std::distance(start, finish);
+  void insert_pending_keys_impl(set_solution_tag) {
+    container_.insert(pending_keys_.begin(), pending_keys_.end());
   }
 
-  [[nodiscard]] static std::size_t get_my_distance(const_iterator start, const_iterator finish) {
-    return get_my_distance_impl(start, finish, solution_tag{});
+  // consecutive 'k' queries are grouped and inserted as one batch
+  void flush_pending_keys() {
+    if (pending_keys_.empty()) {
+      return;
+    }
+
+    insert_pending_keys_impl(solution_tag{});
+    pending_keys_.clear();
   }
 
   template <typename T>
-  bool try_to_read(T& number) const {
-    if (std::cin.eof()) {
+  bool try_to_read(T& number) {
+    if (!input_.read(number)) {
 #if 0
-      std::cerr << kStdCinEOF << "\n";
+      std::cerr << (input_.eof() ? kStdCinEOF : kStdCinFail) << "\n";
       std::cerr << "Input fail at query with index : " << query_index_ << "\n";
 #endif
       return false;
     }
 
-    std::cin >> number;
-    if (std::cin.fail()) {
-    #if 0
-      std::cerr << kStdCinFail << "\n";
-      std::cerr << "Input fail at query with index : " << query_index_ << "\n";
-    #endif
+    return true;
+  }
+
+  bool insert_key() {
+    KeyT key{};
+    if (!try_to_read(key)) {
       return false;
     }
 
+#ifdef LATENCY_HISTOGRAMS_
+    // every 'k' is applied on its own, so latency of single insert is measured, not of batch
+    run_measured(query_types_t::kInsert, [&]() { container_.insert(key); });
+#else
+    pending_keys_.push_back(key);
+    if (pending_keys_.size() >= kMaxInsertBatchSize) {
+      flush_pending_keys();
+    }
+#endif
     return true;
   }
 
-  bool insert_key() {
+  bool erase_key() {
     KeyT key{};
     if (!try_to_read(key)) {
       return false;
     }
 
-    container_.insert(key);
+    container_.erase(key);
     return true;
   }
 
-  bool process_query() const {
+  bool process_query() {
     KeyT low_key{};
     KeyT high_key{};
     
@@ -111,17 +258,17 @@ class solution_t {
       return false;
     }
 
-    const_iterator start = container_.lower_bound(low_key);
-    const_iterator fin   = container_.upper_bound(high_key);
-    std::size_t dist = get_my_distance(start, fin);
-
-#ifndef TIME_MEASUREMENT_
-    std::cout << dist << " ";
+#ifdef LATENCY_HISTOGRAMS_
+    // every 'q' is answered on its own, so latency of single query is measured, not of batch
+    std::size_t dist = 0;
+    run_measured(query_types_t::kQuery, [&]() { dist = count_query_impl(solution_tag{}, low_key, high_key); });
+    write_answer(dist);
 #else
-    // I don't want compiler to optimize away computation of get_my_distance() method
-    do_not_optimize(dist);
+    pending_queries_.emplace_back(low_key, high_key);
+    if (pending_queries_.size() >= kMaxQueryBatchSize) {
+      flush_pending_queries();
+    }
 #endif
-
     return true;
   }
 
@@ -130,6 +277,10 @@ class solution_t {
       return query_types_t::kInsert;
     }
 
+    if (query_type == static_cast<char>(query_types_t::kErase)) {
+      return query_types_t::kErase;
+    }
+
     if (query_type == static_cast<char>(query_types_t::kQuery)) {
       return query_types_t::kQuery;
     }
@@ -142,8 +293,22 @@ class solution_t {
   static constexpr std::string_view kStdCinEOF        = "Error: unexpected end of input...";
   static constexpr std::string_view kUnknownQueryType = "Error: unknown query type...";
 
+ private:
+  static constexpr std::size_t kMaxInsertBatchSize = 1 << 16;
+  static constexpr std::size_t kMaxQueryBatchSize  = 1 << 12;
+
  private:
   ContainerT container_;
+  input_reader_t input_;
+  output_writer_t output_;
+  std::vector<KeyT> pending_keys_;
+  std::vector<std::pair<KeyT, KeyT>> pending_queries_;
+  std::vector<std::size_t> pending_answers_;
+#ifdef LATENCY_HISTOGRAMS_
+  latency_histogram_t insert_latencies_;
+  latency_histogram_t query_latencies_;
+  latency_histogram_t heights_;
+#endif
   std::size_t query_index_{};
 };
 
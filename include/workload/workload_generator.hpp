@@ -0,0 +1,236 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "solutions/binary_query_log.hpp"
+#include "solutions/output_writer.hpp"
+
+// Synthetic query streams for load tests of solutions. Queries are produced one by one,
+// so stream of any length takes O(1) memory, the same config and seed give the same stream.
+namespace workload {
+
+// distribution of keys of 'k' and 'd' queries and of low keys of 'q' queries
+enum class distribution_t {
+  kUniform,   // all keys of [min_key, max_key] are equally likely
+  kZipf,      // few hot keys get most of queries, hot keys are scattered over key range
+  kSorted,    // keys grow from min_key to max_key along the stream
+  kSawtooth,  // keys grow from min_key to max_key and start over kSawtoothTeethCount times
+  kHotRange,  // kHotRangeShare of keys fall into narrow range, the rest are uniform
+  kClustered, // keys are normally distributed around kClustersCount random centers
+  kDrifting   // keys are normally distributed around center, that moves from min_key to max_key
+};
+
+inline std::optional<distribution_t> parse_distribution(std::string_view name) {
+  constexpr std::pair<std::string_view, distribution_t> kNames[] = {
+    {"uniform",   distribution_t::kUniform},   {"zipf",      distribution_t::kZipf},
+    {"sorted",    distribution_t::kSorted},    {"sawtooth",  distribution_t::kSawtooth},
+    {"hot-range", distribution_t::kHotRange},  {"clustered", distribution_t::kClustered},
+    {"drifting",  distribution_t::kDrifting}
+  };
+  for (const auto& [distribution_name, distribution] : kNames) {
+    if (name == distribution_name) {
+      return distribution;
+    }
+  }
+
+  return std::nullopt;
+}
+
+struct workload_config_t {
+  std::uint64_t  queries_count   = 1'000'000;
+  distribution_t distribution    = distribution_t::kUniform;
+  double         insert_share    = 0.3; // the rest after inserts and erases are range queries
+  double         erase_share     = 0.0;
+  std::int64_t   min_key         = -(std::int64_t{1} << 30); // max_key - min_key has to fit into int64
+  std::int64_t   max_key         =   std::int64_t{1} << 30;
+  std::uint64_t  max_range_width = std::uint64_t{1} << 20; // high_key - low_key is in [0, width]
+  double         zipf_exponent   = 0.99; // has to be positive and not 1
+  std::uint64_t  seed            = 228;
+};
+
+struct query_t {
+  char         type; // 'k', 'd' or 'q'
+  std::int64_t low_key;
+  std::int64_t high_key; // only for 'q'
+};
+
+class workload_generator_t {
+ public:
+  explicit workload_generator_t(const workload_config_t& config)
+    : config_(config),
+      rng_(config.seed),
+      key_span_(static_cast<double>(config.max_key) - static_cast<double>(config.min_key)),
+      width_distr_(0, config.max_range_width) {
+    std::uniform_real_distribution<double> position_distr(0.0, 1.0);
+    hot_range_begin_ = position_distr(rng_) * (1.0 - kHotRangeWidth);
+    for (std::size_t cluster_ind = 0; cluster_ind < kClustersCount; ++cluster_ind) {
+      cluster_centers_.push_back(position_distr(rng_));
+    }
+
+    if (config_.distribution == distribution_t::kZipf) {
+      // continuous approximation of Zipf law over ranks [1, keys count] by inverse transform
+      zipf_max_rank_power_ = std::pow(key_span_ + 1.0, 1.0 - config_.zipf_exponent);
+    }
+  }
+
+  bool has_next() const { return query_ind_ < config_.queries_count; }
+
+  query_t next() {
+    const double type_value = unit_distr_(rng_);
+    query_t query{};
+    if (type_value < config_.insert_share) {
+      query = {'k', next_key(), 0};
+    } else if (type_value < config_.insert_share + config_.erase_share) {
+      query = {'d', next_key(), 0};
+    } else {
+      const std::int64_t low_key = next_key();
+      const std::uint64_t max_width = static_cast<std::uint64_t>(config_.max_key) - static_cast<std::uint64_t>(low_key);
+      const std::uint64_t width = std::min(width_distr_(rng_), max_width);
+      query = {'q', low_key, static_cast<std::int64_t>(static_cast<std::uint64_t>(low_key) + width)};
+    }
+
+    ++query_ind_;
+    return query;
+  }
+
+ private:
+  // key at relative position in [0, 1] of key range
+  std::int64_t key_at(double position) const {
+    position = std::clamp(position, 0.0, 1.0);
+    const double offset = std::min(std::floor(position * (key_span_ + 1.0)), key_span_);
+    return static_cast<std::int64_t>(static_cast<std::uint64_t>(config_.min_key) + static_cast<std::uint64_t>(offset));
+  }
+
+  // progress of stream in [0, 1)
+  double stream_position() const {
+    return static_cast<double>(query_ind_) / static_cast<double>(config_.queries_count);
+  }
+
+  std::int64_t next_key() {
+    switch (config_.distribution) {
+      case distribution_t::kZipf: {
+        const double exponent = 1.0 / (1.0 - config_.zipf_exponent);
+        const double rank = std::pow((zipf_max_rank_power_ - 1.0) * unit_distr_(rng_) + 1.0, exponent);
+        // multiplicative hash scatters neighbouring ranks over the whole key range
+        const std::uint64_t scattered_rank = static_cast<std::uint64_t>(rank) * 0x9E3779B97F4A7C15ull;
+        const std::uint64_t keys_count =
+          static_cast<std::uint64_t>(config_.max_key) - static_cast<std::uint64_t>(config_.min_key) + 1;
+        const std::uint64_t offset = keys_count != 0 ? scattered_rank % keys_count : scattered_rank;
+        return static_cast<std::int64_t>(static_cast<std::uint64_t>(config_.min_key) + offset);
+      }
+      case distribution_t::kSorted:
+        return key_at(stream_position());
+      case distribution_t::kSawtooth: {
+        const double teeth_position = stream_position() * kSawtoothTeethCount;
+        return key_at(teeth_position - std::floor(teeth_position));
+      }
+      case distribution_t::kHotRange:
+        if (unit_distr_(rng_) < kHotRangeShare) {
+          return key_at(hot_range_begin_ + unit_distr_(rng_) * kHotRangeWidth);
+        }
+        return key_at(unit_distr_(rng_));
+      case distribution_t::kClustered: {
+        const double center = cluster_centers_[static_cast<std::size_t>(unit_distr_(rng_) * kClustersCount)];
+        return key_at(center + normal_distr_(rng_) * kClusterDeviation);
+      }
+      case distribution_t::kDrifting:
+        return key_at(stream_position() + normal_distr_(rng_) * kDriftDeviation);
+      case distribution_t::kUniform:
+      default:
+        return key_at(unit_distr_(rng_));
+    }
+  }
+
+ private:
+  static constexpr double      kSawtoothTeethCount = 16;
+  static constexpr double      kHotRangeShare      = 0.9;
+  static constexpr double      kHotRangeWidth      = 0.01;  // part of key range
+  static constexpr std::size_t kClustersCount      = 64;
+  static constexpr double      kClusterDeviation   = 0.001; // part of key range
+  static constexpr double      kDriftDeviation     = 0.01;  // part of key range
+
+ private:
+  workload_config_t config_;
+  std::mt19937_64   rng_;
+  double            key_span_;
+  std::uint64_t     query_ind_ = 0;
+
+  std::uniform_real_distribution<double>       unit_distr_{0.0, std::nextafter(1.0, 0.0)};
+  std::normal_distribution<double>             normal_distr_{0.0, 1.0};
+  std::uniform_int_distribution<std::uint64_t> width_distr_;
+
+  double              hot_range_begin_ = 0;
+  std::vector<double> cluster_centers_;
+  double              zipf_max_rank_power_ = 0;
+};
+
+// 'k 10' / 'd 10' / 'q 8 31', one query per line, as tests/tests_generators/generator.py writes
+class text_query_writer_t {
+ public:
+  explicit text_query_writer_t(solution::output_writer_t& output)
+    : output_(output) {}
+
+  void write(const query_t& query) {
+    const char prefix[2] = {query.type, ' '};
+    output_.write_raw(prefix, sizeof(prefix));
+    if (query.type == 'q') {
+      output_.write(query.low_key);
+      output_.write(query.high_key, '\n');
+    } else {
+      output_.write(query.low_key, '\n');
+    }
+  }
+
+ private:
+  solution::output_writer_t& output_;
+};
+
+// binary query log with signed keys, see include/solutions/binary_query_log.hpp. Number of
+// queries is written into header in advance, so stream doesn't need to be rewound
+class binary_query_writer_t {
+ public:
+  binary_query_writer_t(solution::output_writer_t& output, std::uint64_t queries_count, std::size_t key_width)
+    : output_(output), key_width_(key_width) {
+    namespace log = solution::binary_query_log;
+    char header[log::kHeaderSize] = {};
+    std::copy(log::kMagic.begin(), log::kMagic.end(), header);
+    header[log::kVersionOffset]  = static_cast<char>(log::kVersion);
+    header[log::kKeyKindOffset]  = static_cast<char>(log::binary_key_kind_t::kSigned);
+    header[log::kKeyWidthOffset] = static_cast<char>(key_width);
+    store_little_endian(header + log::kQueryCountOffset, queries_count, sizeof(queries_count));
+    output_.write_raw(header, sizeof(header));
+  }
+
+  // keys have to fit into key width
+  void write(const query_t& query) {
+    char bytes[1 + 2 * sizeof(std::uint64_t)] = {query.type};
+    std::size_t size = 1;
+    store_little_endian(bytes + size, static_cast<std::uint64_t>(query.low_key), key_width_);
+    size += key_width_;
+    if (query.type == 'q') {
+      store_little_endian(bytes + size, static_cast<std::uint64_t>(query.high_key), key_width_);
+      size += key_width_;
+    }
+    output_.write_raw(bytes, size);
+  }
+
+ private:
+  static void store_little_endian(char* bytes, std::uint64_t value, std::size_t width) {
+    for (std::size_t byte_ind = 0; byte_ind < width; ++byte_ind) {
+      bytes[byte_ind] = static_cast<char>((value >> (8 * byte_ind)) & 0xFF);
+    }
+  }
+
+ private:
+  solution::output_writer_t& output_;
+  std::size_t                key_width_;
+};
+
+}  // namespace workload
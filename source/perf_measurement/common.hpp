@@ -1,7 +1,18 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
+#include <cstdlib>
 #include <functional>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "perf_counters.hpp"
 
 // prints time of function execution in milliseconds
 inline void measure_exec_time_and_print(std::function<void()> function) {
@@ -12,3 +23,105 @@ inline void measure_exec_time_and_print(std::function<void()> function) {
   auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish_time - start_time);
   std::cout << duration.count() << std::endl;
 }
+
+// returns number after flag, or default_value if there is no such flag
+inline std::size_t find_flag_value(int argc, char* argv[], std::string_view flag, std::size_t default_value) {
+  for (int arg_ind = 1; arg_ind + 1 < argc; ++arg_ind) {
+    if (argv[arg_ind] == flag) {
+      return std::strtoull(argv[arg_ind + 1], nullptr, 10);
+    }
+  }
+
+  return default_value;
+}
+
+inline bool has_flag(int argc, char* argv[], std::string_view flag) {
+  for (int arg_ind = 1; arg_ind < argc; ++arg_ind) {
+    if (argv[arg_ind] == flag) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// solutions, that are built with LATENCY_HISTOGRAMS_, provide print_latency_report()
+template <typename SolutionT, typename = void>
+struct has_latency_report : std::false_type {};
+
+template <typename SolutionT>
+struct has_latency_report<SolutionT, std::void_t<
+  decltype(std::declval<const SolutionT&>().print_latency_report(std::cout))
+>> : std::true_type {};
+
+// solutions with AVL tree provide container().stats()
+template <typename SolutionT, typename = void>
+struct has_tree_stats : std::false_type {};
+
+template <typename SolutionT>
+struct has_tree_stats<SolutionT, std::void_t<
+  decltype(std::declval<const SolutionT&>().container().stats())
+>> : std::true_type {};
+
+// single JSON object, counters are null, if tree isn't compiled with AVL_COUNTERS_
+template <typename StatsT>
+void print_tree_stats_json(std::ostream& out, const StatsT& stats) {
+  out << "{\"size\": " << stats.size << ", \"height\": " << stats.height
+      << ", \"average_search_depth\": " << stats.average_search_depth << ", \"depth_histogram\": [";
+  for (std::size_t depth = 0; depth < stats.depth_histogram.size(); ++depth) {
+    out << (depth == 0 ? "" : ", ") << stats.depth_histogram[depth];
+  }
+  out << "], \"nodes_count\": " << stats.nodes_count << ", \"free_nodes\": " << stats.free_nodes
+      << ", \"nodes_capacity\": " << stats.nodes_capacity << ", \"node_bytes\": " << stats.node_bytes
+      << ", \"memory_bytes\": " << stats.memory_bytes << ", \"bytes_per_key\": " << stats.bytes_per_key
+      << ", \"counters\": ";
+  if (!stats.are_counters_enabled) {
+    out << "null}" << std::endl;
+    return;
+  }
+
+  const auto& counters = stats.counters;
+  out << "{\"inserted_nodes\": " << counters.inserted_nodes << ", \"freed_nodes\": " << counters.freed_nodes
+      << ", \"rebalances\": " << counters.rebalances << ", \"left_rotations\": " << counters.left_rotations
+      << ", \"right_rotations\": " << counters.right_rotations
+      << ", \"rotations_per_insert\": " << stats.rotations_per_insert() << "}}" << std::endl;
+}
+
+// Constructs solution from args ("setup" phase, input is opened or mapped there) and solves it
+// ("solve" phase), prints time of solve in milliseconds. With --perf-counters JSON report of
+// both phases is printed on the next line, see perf_report_t, then latency report of solution,
+// if it has one. Stats of AVL tree are printed with --tree-stats or if counters are compiled in
+template <typename SolutionT, typename... ArgsT>
+int run_solution_measurement(int argc, char* argv[], ArgsT&&... args) {
+  perf_report_t perf_report(has_flag(argc, argv, "--perf-counters"));
+
+  std::optional<SolutionT> solution;
+  perf_report.measure_phase("setup", [&]() {
+    solution.emplace(std::forward<ArgsT>(args)...);
+  });
+  if (!solution->is_input_ok()) {
+    return 1;
+  }
+
+  try {
+    measure_exec_time_and_print([&]() {
+      perf_report.measure_phase("solve", [&]() { solution->solve(); });
+    });
+  } catch (const std::length_error& error) {
+    // more distinct keys, than compact tree can index
+    std::cerr << "Error: " << error.what() << "\n";
+    return 1;
+  }
+  perf_report.print_json(std::cout, solution->queries_count());
+  if constexpr (has_latency_report<SolutionT>::value) {
+    solution->print_latency_report(std::cout);
+  }
+  if constexpr (has_tree_stats<SolutionT>::value) {
+    const auto stats = solution->container().stats();
+    if (stats.are_counters_enabled || has_flag(argc, argv, "--tree-stats")) {
+      print_tree_stats_json(std::cout, stats);
+    }
+  }
+
+  return 0;
+}
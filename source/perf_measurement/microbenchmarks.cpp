@@ -0,0 +1,337 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "AVL/AVL_tree.hpp"
+#include "common.hpp"
+
+// Microbenchmarks of single tree operations: AVL_tree_t against std::set, no parsing or I/O.
+// Every benchmark is repeated kRepetitionsCount times and only mean, median, stddev and cv of
+// repetitions are reported. Besides time per iteration, counters show time per operation
+// ("per_op", in seconds with SI prefix) and operations per second (items_per_second).
+// Flags:
+//   --max-size N     largest tree size, sizes are 1e3, 1e4, ... up to N (default: 1e6, up to 1e8)
+//   --benchmark_*    flags of google benchmark, e.g. --benchmark_filter=avl/lower_bound/uniform
+// Names are container/operation/distribution/key_type/size.
+
+namespace {
+
+constexpr std::size_t kMinSize          = 1000;
+constexpr std::size_t kMaxSize          = 100'000'000;
+constexpr std::size_t kDefaultMaxSize   = 1'000'000;
+constexpr std::size_t kProbesCount      = 1 << 16;
+constexpr std::size_t kClustersCount    = 64;
+constexpr double      kZipfExponent     = 0.99;
+constexpr int         kRepetitionsCount = 5;
+constexpr std::int64_t kKeysRange       = std::int64_t{1} << 30;
+
+enum class distribution_t {
+  kUniform,
+  kSorted,
+  kReverse,
+  kClustered,
+  kZipf
+};
+
+constexpr distribution_t kDistributions[] = {
+  distribution_t::kUniform, distribution_t::kSorted,    distribution_t::kReverse,
+  distribution_t::kClustered, distribution_t::kZipf
+};
+
+std::string_view distribution_name(distribution_t distribution) {
+  switch (distribution) {
+    case distribution_t::kUniform:   return "uniform";
+    case distribution_t::kSorted:    return "sorted";
+    case distribution_t::kReverse:   return "reverse";
+    case distribution_t::kClustered: return "clustered";
+    case distribution_t::kZipf:      return "zipf";
+    default:                         return "unknown";
+  }
+}
+
+// ranks follow continuous approximation of Zipf law, rank is scattered over keys range,
+// so that hot keys are not neighbours
+std::vector<std::int64_t> generate_zipf_keys(std::size_t keys_count, std::mt19937_64& rng) {
+  std::uniform_real_distribution<double> uniform_distr(0.0, 1.0);
+  const double max_rank_power = std::pow(static_cast<double>(keys_count), 1.0 - kZipfExponent);
+
+  std::vector<std::int64_t> keys(keys_count);
+  for (std::int64_t& key : keys) {
+    const double rank = std::pow((max_rank_power - 1.0) * uniform_distr(rng) + 1.0, 1.0 / (1.0 - kZipfExponent));
+    key = static_cast<std::int64_t>(rank) * 0x9E3779B1 % kKeysRange;
+  }
+
+  return keys;
+}
+
+std::vector<std::int64_t> generate_clustered_keys(std::size_t keys_count, std::mt19937_64& rng) {
+  std::uniform_int_distribution<std::int64_t> center_distr(0, kKeysRange);
+  std::vector<std::int64_t> centers(kClustersCount);
+  for (std::int64_t& center : centers) {
+    center = center_distr(rng);
+  }
+
+  std::uniform_int_distribution<std::size_t> cluster_distr(0, kClustersCount - 1);
+  std::normal_distribution<double> offset_distr(0.0, static_cast<double>(kKeysRange) / (kClustersCount * 64));
+  std::vector<std::int64_t> keys(keys_count);
+  for (std::int64_t& key : keys) {
+    const double offset = offset_distr(rng);
+    key = std::clamp<std::int64_t>(centers[cluster_distr(rng)] + static_cast<std::int64_t>(offset), 0, kKeysRange);
+  }
+
+  return keys;
+}
+
+// keys are in [0, kKeysRange], duplicates are possible
+template <typename KeyT>
+std::vector<KeyT> generate_keys(distribution_t distribution, std::size_t keys_count, std::uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::vector<std::int64_t> keys;
+  if (distribution == distribution_t::kClustered) {
+    keys = generate_clustered_keys(keys_count, rng);
+  } else if (distribution == distribution_t::kZipf) {
+    keys = generate_zipf_keys(keys_count, rng);
+  } else {
+    std::uniform_int_distribution<std::int64_t> key_distr(0, kKeysRange);
+    keys.resize(keys_count);
+    for (std::int64_t& key : keys) {
+      key = key_distr(rng);
+    }
+  }
+
+  if (distribution == distribution_t::kSorted) {
+    std::sort(keys.begin(), keys.end());
+  } else if (distribution == distribution_t::kReverse) {
+    std::sort(keys.rbegin(), keys.rend());
+  }
+
+  return std::vector<KeyT>(keys.begin(), keys.end());
+}
+
+// probes for searches are taken from the same distribution as keys, but in random order
+template <typename KeyT>
+std::vector<KeyT> generate_probes(distribution_t distribution) {
+  if (distribution == distribution_t::kSorted || distribution == distribution_t::kReverse) {
+    distribution = distribution_t::kUniform;
+  }
+
+  return generate_keys<KeyT>(distribution, kProbesCount, 1);
+}
+
+struct avl_container_tag {};
+struct set_container_tag {};
+
+template <typename KeyT, typename ContainerTagT>
+struct container_traits_t;
+
+template <typename KeyT>
+struct container_traits_t<KeyT, avl_container_tag> {
+  using container_t = compact_AVL_tree_t<KeyT>;
+  static constexpr std::string_view kName = "avl";
+
+  // O(log n) by subtree sizes
+  static std::size_t distance(typename container_t::const_iterator first,
+                              typename container_t::const_iterator last) {
+    return last - first;
+  }
+};
+
+template <typename KeyT>
+struct container_traits_t<KeyT, set_container_tag> {
+  using container_t = std::set<KeyT>;
+  static constexpr std::string_view kName = "set";
+
+  static std::size_t distance(typename container_t::const_iterator first,
+                              typename container_t::const_iterator last) {
+    return std::distance(first, last);
+  }
+};
+
+template <typename ContainerT, typename KeyT>
+ContainerT build_container(const std::vector<KeyT>& keys) {
+  ContainerT container;
+  for (const KeyT& key : keys) {
+    container.insert(key);
+  }
+
+  return container;
+}
+
+void set_per_op_counters(benchmark::State& state, std::size_t ops_per_iteration) {
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * ops_per_iteration));
+  state.counters["per_op"] = benchmark::Counter(
+    static_cast<double>(ops_per_iteration),
+    benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert
+  );
+}
+
+// inserts all keys into empty container
+template <typename KeyT, typename ContainerTagT>
+void benchmark_insert(benchmark::State& state, distribution_t distribution) {
+  using traits_t = container_traits_t<KeyT, ContainerTagT>;
+  const auto keys = generate_keys<KeyT>(distribution, state.range(0), 0);
+
+  std::size_t container_size = 0;
+  for (auto _ : state) {
+    auto container = build_container<typename traits_t::container_t>(keys);
+    container_size = container.size();
+    benchmark::DoNotOptimize(container_size);
+    benchmark::ClobberMemory();
+  }
+
+  set_per_op_counters(state, keys.size());
+  state.counters["keys"] = static_cast<double>(container_size);
+}
+
+enum class search_type_t {
+  kLowerBound,
+  kUpperBound,
+  kDistance
+};
+
+// one search per iteration, probes are cycled
+template <typename KeyT, typename ContainerTagT>
+void benchmark_search(benchmark::State& state, distribution_t distribution, search_type_t search_type) {
+  using traits_t = container_traits_t<KeyT, ContainerTagT>;
+  const auto container = build_container<typename traits_t::container_t>(
+    generate_keys<KeyT>(distribution, state.range(0), 0)
+  );
+  const auto probes = generate_probes<KeyT>(distribution);
+
+  std::size_t probe_ind = 0;
+  for (auto _ : state) {
+    const KeyT& probe = probes[probe_ind];
+    probe_ind = (probe_ind + 1) % probes.size();
+
+    switch (search_type) {
+      case search_type_t::kLowerBound:
+        benchmark::DoNotOptimize(container.lower_bound(probe));
+        break;
+      case search_type_t::kUpperBound:
+        benchmark::DoNotOptimize(container.upper_bound(probe));
+        break;
+      case search_type_t::kDistance:
+        // number of keys in range of about 1/64 of keys range
+        benchmark::DoNotOptimize(traits_t::distance(
+          container.lower_bound(probe), container.upper_bound(probe + static_cast<KeyT>(kKeysRange / 64))
+        ));
+        break;
+      default:
+        break;
+    }
+  }
+
+  set_per_op_counters(state, 1);
+  state.counters["keys"] = static_cast<double>(container.size());
+}
+
+// in order traversal of the whole container
+template <typename KeyT, typename ContainerTagT>
+void benchmark_iteration(benchmark::State& state, distribution_t distribution) {
+  using traits_t = container_traits_t<KeyT, ContainerTagT>;
+  const auto container = build_container<typename traits_t::container_t>(
+    generate_keys<KeyT>(distribution, state.range(0), 0)
+  );
+
+  for (auto _ : state) {
+    KeyT checksum{};
+    for (auto key_it = container.begin(); key_it != container.end(); ++key_it) {
+      checksum += *key_it;
+    }
+    benchmark::DoNotOptimize(checksum);
+  }
+
+  set_per_op_counters(state, container.size());
+  state.counters["keys"] = static_cast<double>(container.size());
+}
+
+template <typename FuncT>
+void register_benchmark(const std::string& name, std::size_t max_size, FuncT func) {
+  auto* benchmark_ptr = benchmark::RegisterBenchmark(name.c_str(), func);
+  for (std::size_t size = kMinSize; size <= max_size; size *= 10) {
+    benchmark_ptr->Arg(static_cast<std::int64_t>(size));
+  }
+  benchmark_ptr->Repetitions(kRepetitionsCount)->ReportAggregatesOnly(true)->Unit(benchmark::kMicrosecond);
+}
+
+template <typename KeyT, typename ContainerTagT>
+void register_container_benchmarks(std::string_view key_type_name, std::size_t max_size,
+                                   bool all_distributions) {
+  using traits_t = container_traits_t<KeyT, ContainerTagT>;
+  for (distribution_t distribution : kDistributions) {
+    if (!all_distributions && distribution != distribution_t::kUniform) {
+      continue;
+    }
+
+    const std::string suffix = std::string("/") + std::string(distribution_name(distribution)) +
+                               "/" + std::string(key_type_name);
+    const std::string prefix = std::string(traits_t::kName);
+    register_benchmark(prefix + "/insert" + suffix, max_size, [distribution](benchmark::State& state) {
+      benchmark_insert<KeyT, ContainerTagT>(state, distribution);
+    });
+    register_benchmark(prefix + "/lower_bound" + suffix, max_size, [distribution](benchmark::State& state) {
+      benchmark_search<KeyT, ContainerTagT>(state, distribution, search_type_t::kLowerBound);
+    });
+    register_benchmark(prefix + "/upper_bound" + suffix, max_size, [distribution](benchmark::State& state) {
+      benchmark_search<KeyT, ContainerTagT>(state, distribution, search_type_t::kUpperBound);
+    });
+    register_benchmark(prefix + "/distance" + suffix, max_size, [distribution](benchmark::State& state) {
+      benchmark_search<KeyT, ContainerTagT>(state, distribution, search_type_t::kDistance);
+    });
+    register_benchmark(prefix + "/iteration" + suffix, max_size, [distribution](benchmark::State& state) {
+      benchmark_iteration<KeyT, ContainerTagT>(state, distribution);
+    });
+  }
+}
+
+// all distributions for int keys, other key types only with uniform keys
+template <typename ContainerTagT>
+void register_all_benchmarks(std::size_t max_size) {
+  register_container_benchmarks<int,          ContainerTagT>("int",    max_size, true);
+  register_container_benchmarks<std::int64_t, ContainerTagT>("int64",  max_size, false);
+  register_container_benchmarks<double,       ContainerTagT>("double", max_size, false);
+}
+
+// removes --max-size N from arguments, so that google benchmark doesn't reject it
+std::size_t extract_max_size(int& argc, char* argv[]) {
+  const std::size_t max_size = find_flag_value(argc, argv, "--max-size", kDefaultMaxSize);
+
+  int kept_args_count = 0;
+  for (int arg_ind = 0; arg_ind < argc; ++arg_ind) {
+    if (std::string_view(argv[arg_ind]) == "--max-size" && arg_ind + 1 < argc) {
+      ++arg_ind;
+      continue;
+    }
+    argv[kept_args_count++] = argv[arg_ind];
+  }
+  argc = kept_args_count;
+
+  return std::clamp(max_size, kMinSize, kMaxSize);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  const std::size_t max_size = extract_max_size(argc, argv);
+  register_all_benchmarks<avl_container_tag>(max_size);
+  register_all_benchmarks<set_container_tag>(max_size);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  return 0;
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware counters of the calling thread and threads, that it creates later, read through
+// perf_event_open. Every event is opened separately, so event, that isn't supported by CPU
+// (or by VM), is reported as null, while the rest still work. If counters aren't permitted at
+// all (perf_event_paranoid, seccomp, not Linux), is_available() is false and error() tells why.
+// Only user space is counted, so the default perf_event_paranoid = 2 is enough.
+class perf_counters_t {
+ public:
+  static constexpr std::size_t kEventsCount = 7;
+  static constexpr std::array<std::string_view, kEventsCount> kEventNames = {
+    "cycles", "instructions", "l1d_read_misses", "llc_misses", "branch_misses", "dtlb_read_misses",
+    "page_faults"
+  };
+
+  using values_t = std::array<std::optional<std::uint64_t>, kEventsCount>;
+
+ public:
+  perf_counters_t() {
+#ifdef __linux__
+    const std::array<std::pair<std::uint32_t, std::uint64_t>, kEventsCount> events = {{
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {PERF_TYPE_HW_CACHE, get_cache_event_config(PERF_COUNT_HW_CACHE_L1D)},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+      {PERF_TYPE_HW_CACHE, get_cache_event_config(PERF_COUNT_HW_CACHE_DTLB)},
+      {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS}
+    }};
+
+    for (std::size_t event_ind = 0; event_ind < kEventsCount; ++event_ind) {
+      fds_[event_ind] = open_event(events[event_ind].first, events[event_ind].second);
+      if (fds_[event_ind] >= 0) {
+        is_available_ = true;
+      } else if (error_.empty()) {
+        error_ = std::string(kEventNames[event_ind]) + ": " + std::strerror(errno);
+      }
+    }
+#else
+    error_ = "perf_event_open is supported only on Linux";
+#endif
+  }
+
+  perf_counters_t(const perf_counters_t&) = delete;
+  perf_counters_t& operator=(const perf_counters_t&) = delete;
+
+  ~perf_counters_t() {
+#ifdef __linux__
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+#endif
+  }
+
+  // true if at least one event could be opened
+  bool is_available() const { return is_available_; }
+
+  // reason, why the first unavailable event couldn't be opened, empty if all events work
+  const std::string& error() const { return error_; }
+
+  void start() {
+#ifdef __linux__
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+#endif
+  }
+
+  // values since start(), scaled if kernel had to multiplex events on hardware counters
+  values_t stop() {
+    values_t values;
+#ifdef __linux__
+    for (std::size_t event_ind = 0; event_ind < kEventsCount; ++event_ind) {
+      const int fd = fds_[event_ind];
+      if (fd < 0) {
+        continue;
+      }
+
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      std::uint64_t data[3] = {}; // value, time enabled, time running
+      if (read(fd, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) {
+        continue;
+      }
+      values[event_ind] = data[2] == data[1]
+        ? data[0]
+        : static_cast<std::uint64_t>(static_cast<long double>(data[0]) * data[1] / data[2]);
+    }
+#endif
+    return values;
+  }
+
+ private:
+#ifdef __linux__
+  static std::uint64_t get_cache_event_config(std::uint64_t cache_id) {
+    return cache_id | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  }
+
+  static int open_event(std::uint32_t type, std::uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = type;
+    attr.config         = config;
+    attr.disabled       = 1;
+    attr.inherit        = 1; // worker threads of parallel solution are counted too
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+#endif
+
+ private:
+  std::array<int, kEventsCount> fds_{-1, -1, -1, -1, -1, -1, -1};
+  bool        is_available_ = false;
+  std::string error_;
+};
+
+// Wall time and hardware counters of named phases of perf measurement binary, printed as single
+// JSON object. Disabled report doesn't open counters, measure_phase() only calls function then.
+class perf_report_t {
+ private:
+  struct phase_t {
+    std::string                 name;
+    std::uint64_t               wall_ns;
+    perf_counters_t::values_t   values;
+  };
+
+ public:
+  explicit perf_report_t(bool is_enabled) {
+    if (is_enabled) {
+      counters_.emplace();
+    }
+  }
+
+  bool is_enabled() const { return counters_.has_value(); }
+
+  template <typename FuncT>
+  void measure_phase(std::string_view name, FuncT func) {
+    if (!counters_) {
+      func();
+      return;
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+    counters_->start();
+    func();
+    perf_counters_t::values_t values = counters_->stop();
+    auto finish_time = std::chrono::steady_clock::now();
+
+    const auto wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(finish_time - start_time).count();
+    phases_.push_back({std::string(name), static_cast<std::uint64_t>(wall_ns), values});
+  }
+
+  // per operation values are counters divided by operations_count, e.g. number of queries
+  void print_json(std::ostream& out, std::size_t operations_count) const {
+    if (!counters_) {
+      return;
+    }
+
+    out << "{\"available\": " << (counters_->is_available() ? "true" : "false")
+        << ", \"error\": ";
+    print_string(out, counters_->error());
+    out << ", \"operations\": " << operations_count << ", \"phases\": [";
+    for (std::size_t phase_ind = 0; phase_ind < phases_.size(); ++phase_ind) {
+      const phase_t& phase = phases_[phase_ind];
+      out << (phase_ind == 0 ? "" : ", ") << "{\"name\": ";
+      print_string(out, phase.name);
+      out << ", \"wall_ns\": " << phase.wall_ns << ", \"counters\": {";
+      print_values(out, phase.values, 1);
+      out << "}, \"per_operation\": {";
+      print_values(out, phase.values, operations_count);
+      out << "}}";
+    }
+    out << "]}" << std::endl;
+  }
+
+ private:
+  static void print_values(std::ostream& out, const perf_counters_t::values_t& values, std::size_t divisor) {
+    for (std::size_t event_ind = 0; event_ind < perf_counters_t::kEventsCount; ++event_ind) {
+      out << (event_ind == 0 ? "" : ", ") << '"' << perf_counters_t::kEventNames[event_ind] << "\": ";
+      if (!values[event_ind] || divisor == 0) {
+        out << "null";
+      } else if (divisor == 1) {
+        out << *values[event_ind];
+      } else {
+        out << static_cast<double>(*values[event_ind]) / divisor;
+      }
+    }
+  }
+
+  // names and errors have no control characters, only quotes and backslashes are escaped
+  static void print_string(std::ostream& out, std::string_view str) {
+    out << '"';
+    for (char ch : str) {
+      if (ch == '"' || ch == '\\') {
+        out << '\\';
+      }
+      out << ch;
+    }
+    out << '"';
+  }
+
+ private:
+  std::optional<perf_counters_t> counters_;
+  std::vector<phase_t>           phases_;
+};
@@ -5,11 +5,9 @@
 #include "logLib.hpp"
 #include "solutions/solutions_impl.hpp"
 
-int main() {
-  solution::solution_t<AVL_tree_t<int>, int, solution::avl_solution_tag> solution;
-  measure_exec_time_and_print([&solution]{
-    solution.solve();
-  });
+using solution_t = solution::solution_t<compact_AVL_tree_t<int>, int, solution::avl_solution_tag>;
 
-  return 0;
+int main(int argc, char* argv[]) {
+  const char* input_file_path = solution::find_input_file_path(argc, argv);
+  return run_solution_measurement<solution_t>(argc, argv, input_file_path);
 }
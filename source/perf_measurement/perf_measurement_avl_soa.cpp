@@ -0,0 +1,15 @@
+#include <chrono>
+
+#include "AVL/AVL_tree.hpp"
+#include "common.hpp"
+#include "logLib.hpp"
+#include "solutions/solutions_impl.hpp"
+
+using solution_t = solution::solution_t<soa_AVL_tree_t<int>, int, solution::avl_solution_tag>;
+
+// same as avl_perf_measurement, but nodes are stored as struct of arrays,
+// run both on the same input to compare layouts
+int main(int argc, char* argv[]) {
+  const char* input_file_path = solution::find_input_file_path(argc, argv);
+  return run_solution_measurement<solution_t>(argc, argv, input_file_path);
+}
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "AVL/AVL_tree.hpp"
+#include "AVL/utilities.hpp"
+#include "common.hpp"
+#include "concurrent/left_right_tree.hpp"
+#include "logLib.hpp"
+
+// One writer thread inserts and erases random keys without pauses, while readers count
+// keys in random ranges. Throughput of readers is printed for 1, 2, 4, ... readers for
+// tree behind global mutex and for left_right_tree_t.
+// Flags: --max-readers N (default: number of hardware threads), --duration-ms N (default: 500)
+
+namespace {
+
+using tree_t = compact_AVL_tree_t<int>;
+
+constexpr int         kKeysRange        = 1 << 22;
+constexpr std::size_t kInitialKeysCount = 1 << 20;
+constexpr int         kMaxRangeLength   = 1 << 12;
+
+class mutex_tree_t {
+ public:
+  explicit mutex_tree_t(const tree_t& tree)
+    : tree_(tree) {}
+
+  void insert(int key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tree_.insert(key);
+  }
+
+  void erase(int key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tree_.erase(key);
+  }
+
+  std::size_t count_range(int low_key, int high_key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tree_.count_range(low_key, high_key);
+  }
+
+ private:
+  tree_t             tree_;
+  mutable std::mutex mutex_;
+};
+
+tree_t build_initial_tree() {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> key_distr(0, kKeysRange);
+  std::vector<int> keys(kInitialKeysCount);
+  for (int& key : keys) {
+    key = key_distr(rng);
+  }
+
+  return tree_t(keys.begin(), keys.end());
+}
+
+// returns number of reader queries per second
+template <typename ConcurrentTreeT>
+double measure_readers_throughput(ConcurrentTreeT& tree, std::size_t readers_count,
+                                  std::chrono::milliseconds duration) {
+  std::atomic<bool> should_stop{false};
+  std::atomic<std::size_t> queries_count{0};
+
+  std::thread writer([&]() {
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<int> key_distr(0, kKeysRange);
+    while (!should_stop.load(std::memory_order_relaxed)) {
+      const int key = key_distr(rng);
+      tree.insert(key);
+      tree.erase(key_distr(rng));
+    }
+  });
+
+  std::vector<std::thread> readers;
+  for (std::size_t reader_ind = 0; reader_ind < readers_count; ++reader_ind) {
+    readers.emplace_back([&, reader_ind]() {
+      std::mt19937 rng(static_cast<unsigned>(reader_ind + 1));
+      std::uniform_int_distribution<int> key_distr(0, kKeysRange);
+      std::uniform_int_distribution<int> length_distr(0, kMaxRangeLength);
+      std::size_t local_queries_count = 0;
+      std::size_t checksum = 0;
+      while (!should_stop.load(std::memory_order_relaxed)) {
+        const int low_key = key_distr(rng);
+        checksum += tree.count_range(low_key, low_key + length_distr(rng));
+        ++local_queries_count;
+      }
+      do_not_optimize(checksum);
+      queries_count += local_queries_count;
+    });
+  }
+
+  auto start_time = std::chrono::steady_clock::now();
+  std::this_thread::sleep_for(duration);
+  should_stop.store(true);
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  auto finish_time = std::chrono::steady_clock::now();
+  writer.join();
+
+  std::chrono::duration<double> elapsed = finish_time - start_time;
+  return static_cast<double>(queries_count.load()) / elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  const std::size_t max_readers = std::max<std::size_t>(1, find_flag_value(
+    argc, argv, "--max-readers", std::thread::hardware_concurrency()
+  ));
+  const std::chrono::milliseconds duration(find_flag_value(argc, argv, "--duration-ms", 500));
+
+  const tree_t initial_tree = build_initial_tree();
+  mutex_tree_t              mutex_tree(initial_tree);
+  left_right_tree_t<tree_t> left_right_tree(initial_tree);
+
+  std::cout << std::setw(8) << "readers" << std::setw(16) << "mutex, Mq/s" << std::setw(20) << "left-right, Mq/s" << "\n";
+  std::cout << std::fixed << std::setprecision(2);
+  for (std::size_t readers_count = 1; ; readers_count = std::min(readers_count * 2, max_readers)) {
+    double mutex_throughput      = measure_readers_throughput(mutex_tree,      readers_count, duration);
+    double left_right_throughput = measure_readers_throughput(left_right_tree, readers_count, duration);
+    std::cout << std::setw(8)  << readers_count
+              << std::setw(16) << mutex_throughput      / 1e6
+              << std::setw(20) << left_right_throughput / 1e6 << std::endl;
+
+    if (readers_count == max_readers) {
+      break;
+    }
+  }
+
+  return 0;
+}
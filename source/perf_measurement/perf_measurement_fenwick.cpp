@@ -0,0 +1,14 @@
+#include <chrono>
+
+#include "common.hpp"
+#include "fenwick/fenwick_tree.hpp"
+#include "logLib.hpp"
+#include "solutions/fenwick_solution.hpp"
+
+using solution_t = solution::solution_t<fenwick_tree_t<>, int, solution::fenwick_solution_tag>;
+
+// time includes reading of the whole input and compression of keys
+int main(int argc, char* argv[]) {
+  const char* input_file_path = solution::find_input_file_path(argc, argv);
+  return run_solution_measurement<solution_t>(argc, argv, input_file_path);
+}
@@ -0,0 +1,15 @@
+#include <chrono>
+
+#include "AVL/AVL_tree.hpp"
+#include "common.hpp"
+#include "logLib.hpp"
+#include "solutions/parallel_offline_solution.hpp"
+
+using solution_t = solution::solution_t<compact_AVL_tree_t<int>, int, solution::parallel_offline_solution_tag>;
+
+// time includes reading of the whole input, see tests/stress_tests/parallel_scaling.py
+int main(int argc, char* argv[]) {
+  const char* input_file_path = solution::find_input_file_path(argc, argv);
+  std::size_t threads_count   = solution::find_threads_count(argc, argv);
+  return run_solution_measurement<solution_t>(argc, argv, input_file_path, threads_count);
+}
@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "AVL/AVL_tree.hpp"
+#include "AVL/utilities.hpp"
+#include "common.hpp"
+#include "logLib.hpp"
+#include "solutions/offline_queries.hpp"
+
+// Search only benchmark: tree is built from keys of all 'k' queries of input, then lower_bound()
+// and count_range() are run for every 'q' query. Tree with std::less uses branch free descent,
+// tree with generic_less_t (the same order, but unknown comparator) uses branchy one.
+// Batched rows answer the same queries with lower_bound_batch() and count_range_batch().
+// Flags:
+//   --input FILE              query log (text or binary), stdin by default
+//   --repeats N               passes over queries (default: 5)
+//   --comparator less|generic run only one tree, e.g. under 'perf stat -e branches,branch-misses'
+
+namespace {
+
+// the same as std::less<int>, but tree can't tell it
+struct generic_less_t {
+  bool operator()(int lhs, int rhs) const { return lhs < rhs; }
+};
+
+constexpr std::size_t kSearchBatchSize = 1 << 12;
+
+void print_row(std::string_view name, std::size_t keys_count, double elapsed_ns, std::size_t searches_count) {
+  std::cout << std::setw(16) << name << ": " << keys_count << " keys, "
+            << std::fixed << std::setprecision(1)
+            << (searches_count != 0 ? elapsed_ns / searches_count : 0.0)
+            << " ns per lower_bound + count_range" << std::endl;
+}
+
+template <typename TreeT>
+void measure_batched_search(std::string_view name, const TreeT& tree,
+                            const std::vector<std::pair<int, int>>& ranges, std::size_t repeats) {
+  std::vector<int> low_keys;
+  for (const auto& range : ranges) {
+    low_keys.push_back(range.first);
+  }
+  std::vector<typename TreeT::const_iterator> lower_bounds;
+  std::vector<std::size_t> counts;
+  lower_bounds.reserve(kSearchBatchSize);
+  counts.reserve(kSearchBatchSize);
+
+  std::size_t checksum = 0;
+  auto start_time = std::chrono::steady_clock::now();
+  for (std::size_t repeat = 0; repeat < repeats; ++repeat) {
+    for (std::size_t batch_begin = 0; batch_begin < ranges.size(); batch_begin += kSearchBatchSize) {
+      const std::size_t batch_end = std::min(batch_begin + kSearchBatchSize, ranges.size());
+      lower_bounds.clear();
+      counts.clear();
+      tree.lower_bound_batch(low_keys.begin() + batch_begin, low_keys.begin() + batch_end,
+                             std::back_inserter(lower_bounds));
+      tree.count_range_batch(ranges.begin() + batch_begin, ranges.begin() + batch_end,
+                             std::back_inserter(counts));
+      for (std::size_t query_ind = 0; query_ind < lower_bounds.size(); ++query_ind) {
+        checksum += lower_bounds[query_ind] != tree.end() ? static_cast<std::size_t>(*lower_bounds[query_ind]) : 0;
+        checksum += counts[query_ind];
+      }
+    }
+  }
+  auto finish_time = std::chrono::steady_clock::now();
+  do_not_optimize(checksum);
+
+  std::chrono::duration<double, std::nano> elapsed = finish_time - start_time;
+  print_row(name, tree.size(), elapsed.count(), ranges.size() * repeats);
+}
+
+template <typename ComparatorT>
+void measure_search(std::string_view name, const std::vector<solution::offline_query_t<int>>& queries,
+                    std::size_t repeats) {
+  std::vector<int> keys;
+  for (const auto& query : queries) {
+    if (query.type == solution::offline_query_type_t::kInsert) {
+      keys.push_back(query.low_key);
+    }
+  }
+  const compact_AVL_tree_t<int, ComparatorT> tree(keys.begin(), keys.end());
+
+  std::vector<std::pair<int, int>> ranges;
+  for (const auto& query : queries) {
+    if (query.type == solution::offline_query_type_t::kQuery) {
+      ranges.emplace_back(query.low_key, query.high_key);
+    }
+  }
+
+  std::size_t checksum = 0;
+  auto start_time = std::chrono::steady_clock::now();
+  for (std::size_t repeat = 0; repeat < repeats; ++repeat) {
+    for (const auto& [low_key, high_key] : ranges) {
+      auto key_it = tree.lower_bound(low_key);
+      checksum += key_it != tree.end() ? static_cast<std::size_t>(*key_it) : 0;
+      checksum += tree.count_range(low_key, high_key);
+    }
+  }
+  auto finish_time = std::chrono::steady_clock::now();
+  do_not_optimize(checksum);
+
+  std::chrono::duration<double, std::nano> elapsed = finish_time - start_time;
+  print_row(name, tree.size(), elapsed.count(), ranges.size() * repeats);
+  measure_batched_search(std::string(name) + " batched", tree, ranges, repeats);
+}
+
+std::string_view find_comparator_name(int argc, char* argv[]) {
+  for (int arg_ind = 1; arg_ind + 1 < argc; ++arg_ind) {
+    if (std::string_view(argv[arg_ind]) == "--comparator") {
+      return argv[arg_ind + 1];
+    }
+  }
+
+  return {};
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  const std::size_t repeats = find_flag_value(argc, argv, "--repeats", 5);
+  const std::string_view comparator_name = find_comparator_name(argc, argv);
+
+  solution::input_reader_t input(solution::find_input_file_path(argc, argv));
+  if (input.fail()) {
+    return 1;
+  }
+  const auto queries = solution::read_offline_queries<int>(input);
+
+  if (comparator_name.empty() || comparator_name == "less") {
+    measure_search<std::less<int>>("less", queries, repeats);
+  }
+  if (comparator_name.empty() || comparator_name == "generic") {
+    measure_search<generic_less_t>("generic", queries, repeats);
+  }
+
+  return 0;
+}
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "AVL/AVL_tree.hpp"
+#include "AVL/utilities.hpp"
+#include "common.hpp"
+#include "concurrent/sharded_avl.hpp"
+#include "logLib.hpp"
+
+// Insert and range query throughput of sharded_avl_t for 1, 2, 4, ... shards, boundaries of
+// shards are quantiles of sample of keys. The first line is single tree without any threads.
+// Flags: --max-shards N (default: 64), --keys N (default: 2^21), --queries N (default: 2^18)
+
+namespace {
+
+using tree_t = compact_AVL_tree_t<int>;
+
+constexpr int         kKeysRange        = 1 << 30;
+constexpr int         kMaxRangeLength   = 1 << 16;
+constexpr std::size_t kSampleSize       = 1 << 14;
+constexpr std::size_t kQueriesBatchSize = 1 << 12;
+
+struct workload_t {
+  std::vector<int>                 keys;
+  std::vector<std::pair<int, int>> ranges;
+};
+
+workload_t generate_workload(std::size_t keys_count, std::size_t queries_count) {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> key_distr(0, kKeysRange);
+  std::uniform_int_distribution<int> length_distr(0, kMaxRangeLength);
+
+  workload_t workload;
+  workload.keys.resize(keys_count);
+  for (int& key : workload.keys) {
+    key = key_distr(rng);
+  }
+  for (std::size_t query_ind = 0; query_ind < queries_count; ++query_ind) {
+    const int low_key = key_distr(rng);
+    workload.ranges.emplace_back(low_key, low_key + length_distr(rng));
+  }
+
+  return workload;
+}
+
+// returns operations per second
+template <typename FuncT>
+double measure_throughput(std::size_t operations_count, FuncT func) {
+  auto start_time = std::chrono::steady_clock::now();
+  func();
+  auto finish_time = std::chrono::steady_clock::now();
+
+  std::chrono::duration<double> elapsed = finish_time - start_time;
+  return static_cast<double>(operations_count) / elapsed.count();
+}
+
+void print_row(std::size_t shards_count, double insert_throughput, double query_throughput) {
+  std::cout << std::setw(8)  << shards_count
+            << std::setw(18) << insert_throughput / 1e6
+            << std::setw(18) << query_throughput  / 1e6 << std::endl;
+}
+
+void measure_single_tree(const workload_t& workload) {
+  tree_t tree;
+  double insert_throughput = measure_throughput(workload.keys.size(), [&]() {
+    for (int key : workload.keys) {
+      tree.insert(key);
+    }
+  });
+
+  double query_throughput = measure_throughput(workload.ranges.size(), [&]() {
+    std::size_t checksum = 0;
+    for (const auto& [low_key, high_key] : workload.ranges) {
+      checksum += tree.count_range(low_key, high_key);
+    }
+    do_not_optimize(checksum);
+  });
+
+  print_row(0, insert_throughput, query_throughput);
+}
+
+void measure_sharded(const workload_t& workload, std::size_t shards_count) {
+  const std::size_t sample_size = std::min(kSampleSize, workload.keys.size());
+  sharded_avl_t<int> service(range_partition_t<int>::from_sample(
+    workload.keys.begin(), workload.keys.begin() + sample_size, shards_count
+  ));
+
+  double insert_throughput = measure_throughput(workload.keys.size(), [&]() {
+    for (int key : workload.keys) {
+      service.insert(key);
+    }
+    do_not_optimize(service.size()); // waits until all inserts are applied
+  });
+
+  double query_throughput = measure_throughput(workload.ranges.size(), [&]() {
+    std::size_t checksum = 0;
+    for (std::size_t batch_begin = 0; batch_begin < workload.ranges.size(); batch_begin += kQueriesBatchSize) {
+      const std::size_t batch_end = std::min(batch_begin + kQueriesBatchSize, workload.ranges.size());
+      std::vector<std::pair<int, int>> ranges(workload.ranges.begin() + batch_begin,
+                                              workload.ranges.begin() + batch_end);
+      for (std::size_t answer : service.count_range_batch(ranges)) {
+        checksum += answer;
+      }
+    }
+    do_not_optimize(checksum);
+  });
+
+  print_row(service.shards_count(), insert_throughput, query_throughput);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  const std::size_t max_shards    = std::max<std::size_t>(1, find_flag_value(argc, argv, "--max-shards", 64));
+  const std::size_t keys_count    = find_flag_value(argc, argv, "--keys",    1 << 21);
+  const std::size_t queries_count = find_flag_value(argc, argv, "--queries", 1 << 18);
+  const workload_t workload = generate_workload(keys_count, queries_count);
+
+  std::cout << std::setw(8) << "shards" << std::setw(18) << "inserts, Mops/s" << std::setw(18) << "queries, Mq/s" << "\n";
+  std::cout << std::fixed << std::setprecision(2);
+  measure_single_tree(workload);
+  for (std::size_t shards_count = 1; ; shards_count = std::min(shards_count * 2, max_shards)) {
+    measure_sharded(workload, shards_count);
+    if (shards_count == max_shards) {
+      break;
+    }
+  }
+
+  return 0;
+}
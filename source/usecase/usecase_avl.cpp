@@ -1,12 +1,25 @@
+#include <iostream>
+#include <stdexcept>
+
 #include "AVL/AVL_tree.hpp"
 #include "logLib.hpp"
 #include "solutions/solutions_impl.hpp"
 
-int main() {
+int main(int argc, char* argv[]) {
   setLoggingLevel(DEBUG);
 
-  solution::solution_t<AVL_tree_t<int>, int, solution::avl_solution_tag> solution;
-  solution.solve();
+  const char* input_file_path = solution::find_input_file_path(argc, argv);
+  solution::solution_t<compact_AVL_tree_t<int>, int, solution::avl_solution_tag> solution(input_file_path);
+  if (!solution.is_input_ok()) {
+    return 1;
+  }
+  try {
+    solution.solve();
+  } catch (const std::length_error& error) {
+    // more distinct keys, than compact tree can index
+    std::cerr << "Error: " << error.what() << "\n";
+    return 1;
+  }
 
   return 0;
 }
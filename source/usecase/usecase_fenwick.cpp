@@ -0,0 +1,27 @@
+#include "fenwick/fenwick_tree.hpp"
+#include "logLib.hpp"
+#include "solutions/fenwick_solution.hpp"
+
+// reads the whole query stream first, so unlike avl_usecase, it can't answer queries interactively
+int main(int argc, char* argv[]) {
+  setLoggingLevel(DEBUG);
+
+  const char* input_file_path = solution::find_input_file_path(argc, argv);
+  solution::solution_t<fenwick_tree_t<>, int, solution::fenwick_solution_tag> solution(input_file_path);
+  if (!solution.is_input_ok()) {
+    return 1;
+  }
+  solution.solve();
+
+  return 0;
+}
+
+/*
+
+input example from presentation:
+k 10 k 20 q 8 31 q 6 9 k 30 k 40 q 15 40
+
+correct output:
+2 0 3
+
+*/
@@ -0,0 +1,40 @@
+#include <iostream>
+#include <stdexcept>
+
+#include "AVL/AVL_tree.hpp"
+#include "logLib.hpp"
+#include "solutions/parallel_offline_solution.hpp"
+
+// reads the whole query stream first, then answers it with '--threads N' threads
+// (all hardware threads by default)
+int main(int argc, char* argv[]) {
+  setLoggingLevel(DEBUG);
+
+  const char* input_file_path = solution::find_input_file_path(argc, argv);
+  std::size_t threads_count   = solution::find_threads_count(argc, argv);
+  solution::solution_t<compact_AVL_tree_t<int>, int, solution::parallel_offline_solution_tag> solution(
+    input_file_path, threads_count
+  );
+  if (!solution.is_input_ok()) {
+    return 1;
+  }
+  try {
+    solution.solve();
+  } catch (const std::length_error& error) {
+    // more distinct keys, than compact tree can index
+    std::cerr << "Error: " << error.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
+
+/*
+
+input example from presentation:
+k 10 k 20 q 8 31 q 6 9 k 30 k 40 q 15 40
+
+correct output:
+2 0 3
+
+*/
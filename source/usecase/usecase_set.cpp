@@ -3,10 +3,14 @@
 #include "logLib.hpp"
 #include "solutions/solutions_impl.hpp"
 
-int main() {
+int main(int argc, char* argv[]) {
   setLoggingLevel(DEBUG);
 
-  solution::solution_t<std::set<int>, int, solution::set_solution_tag> solution;
+  const char* input_file_path = solution::find_input_file_path(argc, argv);
+  solution::solution_t<std::set<int>, int, solution::set_solution_tag> solution(input_file_path);
+  if (!solution.is_input_ok()) {
+    return 1;
+  }
   solution.solve();
 
   return 0;
@@ -0,0 +1,221 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string_view>
+
+#include "solutions/binary_query_log.hpp"
+#include "solutions/output_writer.hpp"
+#include "workload/workload_generator.hpp"
+
+// Streams synthetic query log in text or binary format, see workload_generator_t.
+// Flags (all optional, unknown flags and malformed values are rejected):
+//   --queries N             number of queries (default: 1000000)
+//   --distribution NAME     uniform|zipf|sorted|sawtooth|hot-range|clustered|drifting (default: uniform)
+//   --insert-share P        share of 'k' queries (default: 0.3)
+//   --erase-share P         share of 'd' queries (default: 0), the rest are 'q' queries
+//   --min-key A --max-key B key range, has to fit into int (default: [-2^30, 2^30])
+//   --max-range-width W     high_key - low_key of 'q' is uniform in [0, W] (default: 2^20)
+//   --zipf-exponent S       exponent of zipf distribution (default: 0.99)
+//   --seed S                seed of random generator (default: 228)
+//   --format text|binary    output format (default: text)
+//   --key-width 1|2|4|8     width of keys in binary format (default: 4)
+//   --output FILE           output file (default: stdout)
+
+namespace {
+
+constexpr std::string_view kUsageMsg =
+  "Usage: workload_generator [--queries N] [--distribution uniform|zipf|sorted|sawtooth|hot-range|clustered|drifting]\n"
+  "                          [--insert-share P] [--erase-share P] [--min-key A] [--max-key B] [--max-range-width W]\n"
+  "                          [--zipf-exponent S] [--seed S] [--format text|binary] [--key-width 1|2|4|8] [--output FILE]\n";
+
+struct options_t {
+  workload::workload_config_t config;
+  bool                        is_binary   = false;
+  std::uint64_t               key_width   = 4;
+  const char*                 output_path = nullptr; // stdout if null
+};
+
+// whole text has to be a number, that fits into type of value
+bool parse_value(const char* text, std::uint64_t& value) {
+  // strtoull silently negates numbers with minus
+  if (std::string_view(text).find('-') != std::string_view::npos) {
+    return false;
+  }
+  char* end = nullptr;
+  errno = 0;
+  value = std::strtoull(text, &end, 10);
+  return errno == 0 && end != text && *end == '\0';
+}
+
+bool parse_value(const char* text, std::int64_t& value) {
+  char* end = nullptr;
+  errno = 0;
+  value = std::strtoll(text, &end, 10);
+  return errno == 0 && end != text && *end == '\0';
+}
+
+bool parse_value(const char* text, double& value) {
+  char* end = nullptr;
+  errno = 0;
+  value = std::strtod(text, &end);
+  return errno == 0 && end != text && *end == '\0' && std::isfinite(value);
+}
+
+constexpr std::string_view kFlags[] = {
+  "--queries", "--distribution", "--insert-share", "--erase-share", "--min-key", "--max-key",
+  "--max-range-width", "--zipf-exponent", "--seed", "--format", "--key-width", "--output"
+};
+
+// flag has to be one of kFlags
+bool parse_flag(options_t& options, std::string_view flag, const char* value) {
+  auto& config = options.config;
+  if (flag == "--queries") {
+    return parse_value(value, config.queries_count);
+  }
+  if (flag == "--insert-share") {
+    return parse_value(value, config.insert_share);
+  }
+  if (flag == "--erase-share") {
+    return parse_value(value, config.erase_share);
+  }
+  if (flag == "--min-key") {
+    return parse_value(value, config.min_key);
+  }
+  if (flag == "--max-key") {
+    return parse_value(value, config.max_key);
+  }
+  if (flag == "--max-range-width") {
+    return parse_value(value, config.max_range_width);
+  }
+  if (flag == "--zipf-exponent") {
+    return parse_value(value, config.zipf_exponent);
+  }
+  if (flag == "--seed") {
+    return parse_value(value, config.seed);
+  }
+  if (flag == "--key-width") {
+    return parse_value(value, options.key_width);
+  }
+  if (flag == "--distribution") {
+    const auto distribution = workload::parse_distribution(value);
+    if (distribution) {
+      config.distribution = *distribution;
+    }
+    return distribution.has_value();
+  }
+  if (flag == "--format") {
+    options.is_binary = std::string_view(value) == "binary";
+    return options.is_binary || std::string_view(value) == "text";
+  }
+  options.output_path = value; // --output, flag is known
+  return true;
+}
+
+// keys of range have to be representable as signed numbers of key_width bytes
+bool do_keys_fit(const workload::workload_config_t& config, std::size_t key_width) {
+  if (key_width == sizeof(std::int64_t)) {
+    return true;
+  }
+
+  const std::int64_t max_value = (std::int64_t{1} << (8 * key_width - 1)) - 1;
+  return config.min_key >= -max_value - 1 && config.max_key <= max_value;
+}
+
+std::optional<options_t> parse_options(int argc, char* argv[]) {
+  options_t options;
+  for (int arg_ind = 1; arg_ind < argc; arg_ind += 2) {
+    const std::string_view flag = argv[arg_ind];
+    if (std::find(std::begin(kFlags), std::end(kFlags), flag) == std::end(kFlags)) {
+      std::cerr << "Error: unknown flag '" << flag << "'\n";
+      return std::nullopt;
+    }
+    if (arg_ind + 1 == argc) {
+      std::cerr << "Error: flag '" << flag << "' has no value\n";
+      return std::nullopt;
+    }
+    const char* value = argv[arg_ind + 1];
+    if (!parse_flag(options, flag, value)) {
+      std::cerr << "Error: invalid value '" << value << "' of flag '" << flag << "'\n";
+      return std::nullopt;
+    }
+  }
+
+  const auto& config = options.config;
+  if (config.insert_share < 0 || config.erase_share < 0 || config.insert_share + config.erase_share > 1) {
+    std::cerr << "Error: shares of inserts and erases have to be non negative with sum <= 1\n";
+    return std::nullopt;
+  }
+  // usecase and perf measurement targets read keys as int, in text and in binary format
+  if (config.min_key > config.max_key ||
+      config.min_key < std::numeric_limits<int>::min() || config.max_key > std::numeric_limits<int>::max()) {
+    std::cerr << "Error: min key has to be less than max key, both have to fit into int\n";
+    return std::nullopt;
+  }
+  if (config.zipf_exponent <= 0 || config.zipf_exponent == 1) {
+    std::cerr << "Error: zipf exponent has to be positive and not 1\n";
+    return std::nullopt;
+  }
+  if (options.is_binary) {
+    if (!solution::binary_query_log::is_valid_key_width(options.key_width)) {
+      std::cerr << "Error: key width has to be 1, 2, 4 or 8\n";
+      return std::nullopt;
+    }
+    if (!do_keys_fit(config, options.key_width)) {
+      std::cerr << "Error: key range doesn't fit into keys of " << options.key_width << " bytes\n";
+      return std::nullopt;
+    }
+  }
+
+  return options;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  const auto options = parse_options(argc, argv);
+  if (!options) {
+    std::cerr << kUsageMsg;
+    return 1;
+  }
+
+  int fd = STDOUT_FILENO;
+  if (options->output_path != nullptr) {
+    fd = open(options->output_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+      std::cerr << "Error: can't open output file '" << options->output_path << "'\n";
+      return 1;
+    }
+  }
+
+  {
+    solution::output_writer_t output(fd);
+    workload::workload_generator_t generator(options->config);
+    if (!options->is_binary) {
+      workload::text_query_writer_t writer(output);
+      while (generator.has_next()) {
+        writer.write(generator.next());
+      }
+    } else {
+      workload::binary_query_writer_t writer(output, options->config.queries_count, options->key_width);
+      while (generator.has_next()) {
+        writer.write(generator.next());
+      }
+    }
+  } // output is flushed by destructor
+
+  if (fd != STDOUT_FILENO) {
+    close(fd);
+  }
+
+  return 0;
+}
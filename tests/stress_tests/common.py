@@ -6,6 +6,10 @@ GENERATED_TESTS_DIR_PATH = PARENT_DIR_PATH / "../tests_data"
 SOLUTIONS_BINARIES_DIR = PARENT_DIR_PATH / "../../build/source/usecase/"
 AVL_SOLUTION_PATH = SOLUTIONS_BINARIES_DIR / "avl_usecase"
 SET_SOLUTION_PATH = SOLUTIONS_BINARIES_DIR / "set_usecase"
+FENWICK_SOLUTION_PATH = SOLUTIONS_BINARIES_DIR / "fenwick_usecase"
+PARALLEL_SOLUTION_PATH = SOLUTIONS_BINARIES_DIR / "parallel_usecase"
+PERF_BINARIES_DIR = PARENT_DIR_PATH / "../../build/source/perf_measurement/"
+PARALLEL_PERF_PATH = PERF_BINARIES_DIR / "parallel_perf_measurement"
 
 def run_solution(solution_name: str, test_data: str) -> str:
   return sub.run(solution_name, input=test_data, text=True, capture_output=True).stdout
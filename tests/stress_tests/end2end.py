@@ -1,6 +1,10 @@
 import os
 from typing import List
-from common import run_solution, AVL_SOLUTION_PATH, SET_SOLUTION_PATH, GENERATED_TESTS_DIR_PATH
+from common import run_solution, AVL_SOLUTION_PATH, SET_SOLUTION_PATH, FENWICK_SOLUTION_PATH, PARALLEL_SOLUTION_PATH, GENERATED_TESTS_DIR_PATH
+
+# every solution is compared with set solution
+CHECKED_SOLUTIONS = [("AVL", AVL_SOLUTION_PATH), ("FENWICK", FENWICK_SOLUTION_PATH),
+                     ("PARALLEL", PARALLEL_SOLUTION_PATH)]
 
 def find_first_differ(lhs: List[str], rhs: List[str]) -> int:
   assert len(lhs) == len(rhs)
@@ -11,20 +15,20 @@ def find_first_differ(lhs: List[str], rhs: List[str]) -> int:
   return -1
 
 
-def compare_outputs(avl_sol_output: str, set_sol_output: str) -> str:
-  if avl_sol_output == set_sol_output:
+def compare_outputs(sol_name: str, sol_output: str, set_sol_output: str) -> bool:
+  if sol_output == set_sol_output:
     return True
 
-  avl_answers = avl_sol_output.split()
+  sol_answers = sol_output.split()
   set_answers = set_sol_output.split()
-  # print(avl_answers, set_answers)
-  if len(avl_answers) != len(set_answers):
+  # print(sol_answers, set_answers)
+  if len(sol_answers) != len(set_answers):
     print("Error: answers have different number of elements")
     return False
   
-  diff_ind = find_first_differ(avl_answers, set_answers)
+  diff_ind = find_first_differ(sol_answers, set_answers)
   print(f"First difference at query #{diff_ind}:\
-          AVL='{avl_answers[diff_ind]}', SET='{set_answers[diff_ind]}'")
+          {sol_name}='{sol_answers[diff_ind]}', SET='{set_answers[diff_ind]}'")
   return False
 
 
@@ -32,9 +36,13 @@ def run_test_case(filename: str) -> bool:
   with open(filename, "r") as file:
     test_case_data = file.read()
 
-  avl_sol_output = run_solution(AVL_SOLUTION_PATH, test_case_data)
   set_sol_output = run_solution(SET_SOLUTION_PATH, test_case_data)
-  return compare_outputs(avl_sol_output, set_sol_output)
+  for sol_name, sol_path in CHECKED_SOLUTIONS:
+    sol_output = run_solution(sol_path, test_case_data)
+    if not compare_outputs(sol_name, sol_output, set_sol_output):
+      return False
+
+  return True
 
 
 if __name__ == "__main__":
@@ -51,4 +59,4 @@ if __name__ == "__main__":
         print(f"Correctness test has failed on test case {full_filename}")
         exit(0)
 
-  print("Correctness test has passed, avl and set solution are most likely work the same")
+  print("Correctness test has passed, avl, fenwick and set solutions are most likely work the same")
@@ -0,0 +1,47 @@
+from common import PARALLEL_PERF_PATH, GENERATED_TESTS_DIR_PATH
+from pathlib import Path
+from typing import List
+import argparse
+import os
+import statistics
+import subprocess as sub
+
+# Runs parallel_perf_measurement on the same query log with 1, 2, 4, ... N threads
+# and prints time and speedup relative to single thread.
+
+def measure_time_ms(test_file: Path, threads_count: int) -> int:
+  output = sub.run(
+    [PARALLEL_PERF_PATH, "--input", test_file, "--threads", str(threads_count)],
+    text=True, capture_output=True, check=True
+  ).stdout
+  return int(output.split()[0])
+
+
+def get_threads_counts(max_threads: int) -> List[int]:
+  threads_counts = []
+  threads_count = 1
+  while threads_count < max_threads:
+    threads_counts.append(threads_count)
+    threads_count *= 2
+  threads_counts.append(max_threads)
+  return threads_counts
+
+
+if __name__ == "__main__":
+  parser = argparse.ArgumentParser(description="Scaling of parallel offline solution")
+  parser.add_argument("--input", type=Path, default=GENERATED_TESTS_DIR_PATH / "large/test_0.dat",
+                      help="query log (text or binary)")
+  parser.add_argument("--max-threads", type=int, default=os.cpu_count())
+  parser.add_argument("--repeats", type=int, default=3, help="median of this many runs is taken")
+  args = parser.parse_args()
+
+  print(f"{'threads':>8} {'time, ms':>10} {'speedup':>8}")
+  single_thread_time = None
+  for threads_count in get_threads_counts(args.max_threads):
+    time_ms = statistics.median(
+      measure_time_ms(args.input, threads_count) for _ in range(args.repeats)
+    )
+    if single_thread_time is None:
+      single_thread_time = time_ms
+    speedup = single_thread_time / time_ms if time_ms != 0 else float("inf")
+    print(f"{threads_count:>8} {time_ms:>10} {speedup:>8.2f}")
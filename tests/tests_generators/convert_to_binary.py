@@ -0,0 +1,86 @@
+from pathlib import Path
+from typing import List
+import argparse
+import struct
+
+# Converts text query stream ('k 10 q 8 31 d 10') into binary query log,
+# that is read by usecase and perf measurement targets without any parsing.
+# Format is described in include/solutions/binary_query_log.hpp
+
+PARENT_DIR_PATH = Path(__file__).parent.absolute()
+GENERATED_TESTS_DIR_PATH = PARENT_DIR_PATH / "../tests_data"
+BINARY_TESTS_DIR_PATH = PARENT_DIR_PATH / "../tests_data_binary"
+
+MAGIC = b"AVLQ"
+VERSION = 1
+KEY_KIND_SIGNED = 0
+KEY_KIND_UNSIGNED = 1
+KEYS_PER_OPCODE = {"k": 1, "d": 1, "q": 2}
+
+
+def encode_queries(text: str, key_width: int, is_signed: bool) -> bytes:
+  tokens = text.split()
+  body = bytearray()
+  num_queries = 0
+  token_ind = 0
+  while token_ind < len(tokens):
+    opcode = tokens[token_ind]
+    if opcode not in KEYS_PER_OPCODE:
+      raise ValueError(f"unknown query type '{opcode}' at token {token_ind}")
+
+    num_keys = KEYS_PER_OPCODE[opcode]
+    keys = tokens[token_ind + 1 : token_ind + 1 + num_keys]
+    if len(keys) != num_keys:
+      raise ValueError(f"query '{opcode}' at token {token_ind} is cut by the end of input")
+
+    body += opcode.encode()
+    for key in keys:
+      body += int(key).to_bytes(key_width, "little", signed=is_signed)
+
+    num_queries += 1
+    token_ind += 1 + num_keys
+
+  key_kind = KEY_KIND_SIGNED if is_signed else KEY_KIND_UNSIGNED
+  header = MAGIC + struct.pack("<BBBBQ", VERSION, key_kind, key_width, 0, num_queries)
+  return bytes(header + body)
+
+
+def convert_file(input_file: Path, output_file: Path, key_width: int, is_signed: bool) -> None:
+  with open(input_file, "r") as f:
+    binary_log = encode_queries(f.read(), key_width, is_signed)
+
+  output_file.parent.mkdir(parents=True, exist_ok=True)
+  with open(output_file, "wb") as f:
+    f.write(binary_log)
+
+
+def convert_generated_tests(key_width: int, is_signed: bool) -> List[Path]:
+  converted_files = []
+  for input_file in sorted(GENERATED_TESTS_DIR_PATH.glob("*/*.dat")):
+    suite_name = input_file.parent.name
+    output_file = BINARY_TESTS_DIR_PATH / suite_name / (input_file.stem + ".bin")
+    convert_file(input_file, output_file, key_width, is_signed)
+    converted_files.append(output_file)
+
+  return converted_files
+
+
+if __name__ == "__main__":
+  parser = argparse.ArgumentParser(
+    description="Converts text query streams into binary query logs. "
+                "Without arguments every test from tests/tests_data is converted into tests/tests_data_binary."
+  )
+  parser.add_argument("input",  nargs="?", type=Path, help="text query stream")
+  parser.add_argument("output", nargs="?", type=Path, help="path of binary query log")
+  parser.add_argument("--key-width", type=int, default=4, choices=[1, 2, 4, 8],
+                      help="bytes per key (default: 4)")
+  parser.add_argument("--unsigned", action="store_true", help="encode keys as unsigned integers")
+  args = parser.parse_args()
+
+  if args.input is None:
+    converted_files = convert_generated_tests(args.key_width, not args.unsigned)
+    print(f"converted {len(converted_files)} tests into {BINARY_TESTS_DIR_PATH.resolve()}")
+  else:
+    if args.output is None:
+      parser.error("output path is required together with input path")
+    convert_file(args.input, args.output, args.key_width, not args.unsigned)
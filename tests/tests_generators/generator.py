@@ -11,6 +11,9 @@ ASK_WITHIN_RANGE_PROB = 0.8
 def add_insert_query(test_data, key) -> None:
   test_data.append(f"k {key}")
 
+def add_erase_query(test_data, key) -> None:
+  test_data.append(f"d {key}")
+
 def add_range_query(test_data, min_key, max_key) -> None:
   test_data.append(f"q {min_key} {max_key}")
 
@@ -18,6 +21,7 @@ def generate_queries(
   num_queries: int,
   key_range: Tuple[int,int],
   insert_prob: float,
+  erase_prob: float = 0.0,
   # seed: int
 ) -> str:
   # random.seed(seed)
@@ -29,6 +33,9 @@ def generate_queries(
       key = random.randint(key_range[0], key_range[1])
       add_insert_query(test_data, key)
       # existing_key.add(key)
+    elif erase_prob > 0 and random.uniform(0, 1) < erase_prob / (1 - insert_prob):
+      key = random.randint(key_range[0], key_range[1])
+      add_erase_query(test_data, key)
     else:
       # if existing_key and random.uniform(0, 1) < ASK_WITHIN_RANGE_PROB:
       #   min_key = min(existing_key)
@@ -52,6 +59,7 @@ def generate_test_case_suite(
   num_queries: int,
   key_range: Tuple[int,int],
   insert_prob: float,
+  erase_prob: float = 0.0,
 ) -> None:
   output_dir = base_dir / test_case_name
   output_dir.mkdir(exist_ok=True)
@@ -59,7 +67,7 @@ def generate_test_case_suite(
   for test_id in range(num_test_cases):
     output_file = output_dir / f"test_{test_id}.dat"
     test_case = generate_queries(
-      num_queries, key_range, insert_prob
+      num_queries, key_range, insert_prob, erase_prob
     )
 
     with open(output_file, "w") as f:
@@ -73,3 +81,5 @@ if __name__ == "__main__":
   generate_test_case_suite(GENERATED_TESTS_DIR_PATH, "small",  10, 1000,   (-1000,   1000),   0.3)
   generate_test_case_suite(GENERATED_TESTS_DIR_PATH, "medium", 10, 10000,  (-10000,  10000),  0.3)
   generate_test_case_suite(GENERATED_TESTS_DIR_PATH, "large",  10, 100000, (-100000, 100000), 0.3)
+  # sliding window like workload: keys are constantly inserted and erased
+  generate_test_case_suite(GENERATED_TESTS_DIR_PATH, "churn",  10, 100000, (-1000,   1000),   0.4, 0.3)
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include "AVL/AVL_persistent_tree.hpp"
+
+namespace {
+
+template <typename VersionT>
+std::vector<int> collect_keys(const VersionT& version) {
+  std::vector<int> keys;
+  for (int key : version) {
+    keys.push_back(key);
+  }
+
+  return keys;
+}
+
+} // namespace
+
+TEST(AVLPersistentTree, EmptyVersion) {
+  persistent_AVL_tree_t<int> tree;
+  EXPECT_EQ(tree.versions_count(), 1);
+  EXPECT_TRUE(tree.latest().empty());
+  EXPECT_EQ(tree.latest().size(), 0);
+  EXPECT_EQ(tree.latest().begin(), tree.latest().end());
+  EXPECT_EQ(tree.latest().count_range(-10, 10), 0);
+  EXPECT_EQ(tree.latest().lower_bound(5), tree.latest().end());
+}
+
+TEST(AVLPersistentTree, OldVersionsDontChange) {
+  persistent_AVL_tree_t<int> tree;
+  const std::size_t v1 = tree.insert(20);
+  const std::size_t v2 = tree.insert(10);
+  const std::size_t v3 = tree.insert(30);
+  const std::size_t v4 = tree.erase(20);
+  const std::size_t v5 = tree.erase(42);
+
+  EXPECT_EQ(v5, 5);
+  EXPECT_EQ(collect_keys(tree.version(0)),  std::vector<int>{});
+  EXPECT_EQ(collect_keys(tree.version(v1)), std::vector<int>({20}));
+  EXPECT_EQ(collect_keys(tree.version(v2)), std::vector<int>({10, 20}));
+  EXPECT_EQ(collect_keys(tree.version(v3)), std::vector<int>({10, 20, 30}));
+  EXPECT_EQ(collect_keys(tree.version(v4)), std::vector<int>({10, 30}));
+  EXPECT_EQ(collect_keys(tree.version(v5)), std::vector<int>({10, 30}));
+
+  EXPECT_EQ(tree.version(v3).count_range(15, 30), 2);
+  EXPECT_EQ(tree.version(v4).count_range(15, 30), 1);
+  EXPECT_TRUE (tree.version(v3).contains(20));
+  EXPECT_FALSE(tree.version(v4).contains(20));
+  EXPECT_EQ(*tree.version(v3).lower_bound(11), 20);
+  EXPECT_EQ(*tree.version(v4).lower_bound(11), 30);
+  EXPECT_EQ(*tree.version(v3).upper_bound(20), 30);
+  EXPECT_EQ(tree.version(v4).upper_bound(30), tree.version(v4).end());
+}
+
+TEST(AVLPersistentTree, DuplicateInsertCreatesSameVersion) {
+  persistent_AVL_tree_t<int> tree;
+  tree.insert(1);
+  const std::size_t nodes_count = tree.nodes_count();
+  const std::size_t version_ind = tree.insert(1);
+
+  EXPECT_EQ(version_ind, 2);
+  EXPECT_EQ(tree.nodes_count(), nodes_count);
+  EXPECT_EQ(tree.version(version_ind).size(), 1);
+}
+
+TEST(AVLPersistentTree, UnknownVersionThrows) {
+  persistent_AVL_tree_t<int> tree;
+  tree.insert(1);
+  EXPECT_THROW(tree.version(2), std::out_of_range);
+}
+
+TEST(AVLPersistentTree, IteratorsSurviveLaterUpdates) {
+  persistent_AVL_tree_t<int> tree;
+  for (int key = 0; key < 10; ++key) {
+    tree.insert(key);
+  }
+
+  auto version = tree.latest();
+  auto it = version.lower_bound(5);
+  for (int key = 10; key < 1000; ++key) {
+    tree.insert(key); // arena is reallocated many times
+  }
+
+  std::vector<int> tail(it, version.end());
+  EXPECT_EQ(tail, std::vector<int>({5, 6, 7, 8, 9}));
+}
+
+TEST(AVLPersistentTree, OldVersionIteratorReadsBetweenUpdates) {
+  persistent_AVL_tree_t<int> tree;
+  for (int key = 0; key < 100; key += 10) {
+    tree.insert(key);
+  }
+
+  const auto version = tree.latest();
+  int new_key = 1000;
+  int expected_key = 0;
+  for (auto it = version.begin(); it != version.end(); ++it, expected_key += 10) {
+    for (int update_ind = 0; update_ind < 100; ++update_ind) {
+      tree.insert(new_key++); // arena is reallocated, keys are read through iterator only after it
+    }
+    EXPECT_EQ(*it, expected_key);
+    EXPECT_EQ(*it.operator->(), expected_key);
+  }
+  EXPECT_EQ(expected_key, 100);
+  EXPECT_EQ(tree.latest().size(), 1010);
+}
+
+// update appends O(log n) nodes instead of copying the whole tree
+TEST(AVLPersistentTree, UpdateCopiesOnlyPath) {
+  persistent_AVL_tree_t<int, std::less<int>, std::uint32_t> tree;
+  const int keys_count = 1 << 16;
+  for (int key = 0; key < keys_count; ++key) {
+    tree.insert(key);
+  }
+
+  for (int key = 0; key < keys_count; key += 97) {
+    const std::size_t nodes_before_insert = tree.nodes_count();
+    tree.insert(keys_count + key);
+    EXPECT_LE(tree.nodes_count() - nodes_before_insert, 2 * 17 + 2);
+
+    const std::size_t nodes_before_erase = tree.nodes_count();
+    tree.erase(key);
+    EXPECT_LE(tree.nodes_count() - nodes_before_erase, 2 * 17 + 2);
+  }
+}
+
+TEST(AVLPersistentTree, MatchesSetSnapshots) {
+  std::mt19937 rng(31);
+  std::uniform_int_distribution<int> key_distr(-300, 300);
+
+  persistent_AVL_tree_t<int> tree;
+  std::set<int> keys;
+  std::vector<std::set<int>> snapshots = {keys};
+  for (int update_ind = 0; update_ind < 3000; ++update_ind) {
+    const int key = key_distr(rng);
+    if (rng() % 3 == 0) {
+      tree.erase(key);
+      keys.erase(key);
+    } else {
+      tree.insert(key);
+      keys.insert(key);
+    }
+    snapshots.push_back(keys);
+  }
+
+  ASSERT_EQ(tree.versions_count(), snapshots.size());
+  for (std::size_t version_ind = 0; version_ind < snapshots.size(); version_ind += 7) {
+    const std::set<int>& snapshot = snapshots[version_ind];
+    auto version = tree.version(version_ind);
+    ASSERT_EQ(collect_keys(version), std::vector<int>(snapshot.begin(), snapshot.end()));
+
+    for (int query_ind = 0; query_ind < 20; ++query_ind) {
+      int low_key  = key_distr(rng);
+      int high_key = key_distr(rng);
+      std::size_t expected = low_key <= high_key
+        ? std::distance(snapshot.lower_bound(low_key), snapshot.upper_bound(high_key))
+        : 0;
+      EXPECT_EQ(version.count_range(low_key, high_key), expected);
+
+      auto expected_it = snapshot.lower_bound(low_key);
+      auto it = version.lower_bound(low_key);
+      if (expected_it == snapshot.end()) {
+        EXPECT_EQ(it, version.end());
+      } else {
+        ASSERT_NE(it, version.end());
+        EXPECT_EQ(*it, *expected_it);
+      }
+    }
+  }
+}
@@ -1,5 +1,13 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
 #include "AVL/AVL_tree.hpp"
 
 TEST(AVLTreeCommon, DefaultConstructor) {
@@ -87,6 +95,21 @@ TEST(AVLTreeCommon, BalanceAfterInsertion) {
   }
   
   EXPECT_EQ(elements, (std::vector<int>{1, 2, 3}));
+  EXPECT_EQ(tree.height(), 2);
+}
+
+TEST(AVLTreeCommon, HeightIsLogarithmic) {
+  AVL_tree_t<int> tree;
+  EXPECT_EQ(tree.height(), 0);
+
+  tree.insert(1);
+  EXPECT_EQ(tree.height(), 1);
+
+  // sorted insertions are the worst case for unbalanced tree
+  for (int key = 2; key < (1 << 10); ++key) {
+    tree.insert(key);
+  }
+  EXPECT_EQ(tree.height(), 10);
 }
 
 TEST(AVLTreeCommon, DuplicateValues) {
@@ -161,3 +184,265 @@ TEST(AVLTreeCommon, ConstIterators) {
   
   EXPECT_EQ(elements, (std::vector<int>{1, 2, 3}));
 }
+
+TEST(AVLTreeCommon, RandomInsertionsMatchStdSet) {
+  AVL_tree_t<int> tree;
+  std::set<int> etalon;
+
+  std::mt19937 rng(42);
+  for (int i = 0; i < 5000; ++i) {
+    int key = static_cast<int>(rng() % 2000) - 1000;
+    tree.insert(key);
+    etalon.insert(key);
+  }
+
+  std::vector<int> actual;
+  for (auto it = tree.begin(); it != tree.end(); ++it) {
+    actual.push_back(*it);
+  }
+  EXPECT_EQ(actual, std::vector<int>(etalon.begin(), etalon.end()));
+  EXPECT_EQ(static_cast<std::size_t>(tree.end() - tree.begin()), etalon.size());
+}
+
+TEST(AVLTreeCommon, CompactTreeMatchesStdSet) {
+  compact_AVL_tree_t<int> tree;
+  std::set<int> etalon;
+
+  std::mt19937 rng(1337);
+  for (int i = 0; i < 20000; ++i) {
+    int key = static_cast<int>(rng() % 3000) - 1500;
+    if (rng() % 3 == 0) {
+      EXPECT_EQ(tree.erase(key), etalon.erase(key));
+    } else {
+      tree.insert(key);
+      etalon.insert(key);
+    }
+  }
+
+  std::vector<int> actual;
+  for (auto it = tree.begin(); it != tree.end(); ++it) {
+    actual.push_back(*it);
+  }
+  EXPECT_EQ(actual, std::vector<int>(etalon.begin(), etalon.end()));
+  EXPECT_EQ(tree.size(), etalon.size());
+  EXPECT_EQ(tree.count_range(-100, 100),
+            static_cast<std::size_t>(std::distance(etalon.lower_bound(-100), etalon.upper_bound(100))));
+}
+
+TEST(AVLTreeCommon, CompactTreeMaxSize) {
+  EXPECT_EQ(compact_AVL_tree_t<int>::max_size(), (std::size_t{1} << 26) - 2);
+  EXPECT_GT(AVL_tree_t<int>::max_size(), compact_AVL_tree_t<int>::max_size());
+}
+
+TEST(AVLTreeCommon, StructOfArraysStorageMatchesStdSet) {
+  soa_AVL_tree_t<int> tree;
+  std::set<int> etalon;
+
+  std::mt19937 rng(2024);
+  for (int i = 0; i < 20000; ++i) {
+    int key = static_cast<int>(rng() % 3000) - 1500;
+    if (rng() % 3 == 0) {
+      EXPECT_EQ(tree.erase(key), etalon.erase(key));
+    } else {
+      tree.insert(key);
+      etalon.insert(key);
+    }
+  }
+
+  std::vector<int> actual;
+  for (auto it = tree.begin(); it != tree.end(); ++it) {
+    actual.push_back(*it);
+  }
+  EXPECT_EQ(actual, std::vector<int>(etalon.begin(), etalon.end()));
+  EXPECT_EQ(*tree.select(tree.size() / 2), *std::next(etalon.begin(), etalon.size() / 2));
+}
+
+TEST(AVLTreeCommon, StructOfArraysStringKeys) {
+  soa_AVL_tree_t<std::string> tree{"banana", "apple", "cherry"};
+  tree.erase("banana");
+
+  std::vector<std::string> elements;
+  for (auto it = tree.begin(); it != tree.end(); ++it) {
+    elements.push_back(*it);
+  }
+  EXPECT_EQ(elements, (std::vector<std::string>{"apple", "cherry"}));
+}
+
+TEST(AVLTreeCommon, RangeConstructorUnsorted) {
+  std::vector<int> keys{7, 3, 9, 3, 1, 7, 5};
+  AVL_tree_t<int> tree(keys.begin(), keys.end());
+
+  std::vector<int> elements;
+  for (auto it = tree.begin(); it != tree.end(); ++it) {
+    elements.push_back(*it);
+  }
+  EXPECT_EQ(elements, (std::vector<int>{1, 3, 5, 7, 9}));
+  EXPECT_EQ(tree.size(), 5);
+}
+
+TEST(AVLTreeCommon, RangeConstructorCustomComparator) {
+  std::vector<int> keys{1, 3, 2, 3};
+  AVL_tree_t<int, std::greater<int>> tree(keys.begin(), keys.end());
+
+  std::vector<int> elements;
+  for (auto it = tree.begin(); it != tree.end(); ++it) {
+    elements.push_back(*it);
+  }
+  EXPECT_EQ(elements, (std::vector<int>{3, 2, 1}));
+}
+
+TEST(AVLTreeCommon, AssignSorted) {
+  AVL_tree_t<int> tree{100, 200};
+  std::vector<int> keys{1, 2, 2, 3, 5, 8, 8, 13};
+  tree.assign_sorted(keys.begin(), keys.end());
+
+  std::vector<int> elements;
+  for (auto it = tree.begin(); it != tree.end(); ++it) {
+    elements.push_back(*it);
+  }
+  EXPECT_EQ(elements, (std::vector<int>{1, 2, 3, 5, 8, 13}));
+  EXPECT_EQ(tree.count_range(2, 8), 4);
+  EXPECT_EQ(*tree.select(4), 8);
+}
+
+TEST(AVLTreeCommon, BulkBuiltTreeSupportsUpdates) {
+  std::vector<int> keys;
+  for (int i = 0; i < 10000; i += 2) {
+    keys.push_back(i);
+  }
+  compact_AVL_tree_t<int> tree;
+  tree.assign_sorted(keys.begin(), keys.end());
+  std::set<int> etalon(keys.begin(), keys.end());
+
+  std::mt19937 rng(7);
+  for (int i = 0; i < 10000; ++i) {
+    int key = static_cast<int>(rng() % 12000);
+    if (rng() % 2 == 0) {
+      tree.insert(key);
+      etalon.insert(key);
+    } else {
+      EXPECT_EQ(tree.erase(key), etalon.erase(key));
+    }
+  }
+
+  std::vector<int> actual;
+  for (auto it = tree.begin(); it != tree.end(); ++it) {
+    actual.push_back(*it);
+  }
+  EXPECT_EQ(actual, std::vector<int>(etalon.begin(), etalon.end()));
+}
+
+TEST(AVLTreeCommon, InsertBatchSmall) {
+  AVL_tree_t<int> tree;
+  for (int i = 0; i < 1000; i += 10) {
+    tree.insert(i);
+  }
+
+  std::vector<int> batch{55, 5, 995, 5, 10, -3};  // Unsorted, with duplicates
+  tree.insert_batch(batch.begin(), batch.end());
+
+  EXPECT_EQ(tree.size(), 104);
+  EXPECT_EQ(*tree.begin(), -3);
+  EXPECT_EQ(*tree.lower_bound(51), 55);
+  EXPECT_EQ(tree.count_range(0, 10), 3);
+}
+
+TEST(AVLTreeCommon, InsertBatchLarge) {
+  AVL_tree_t<int> tree{1, 3, 5};
+  std::vector<int> batch;
+  for (int i = 10; i > 0; --i) {
+    batch.push_back(i);
+  }
+  tree.insert_batch(batch.begin(), batch.end());
+
+  std::vector<int> elements;
+  for (auto it = tree.begin(); it != tree.end(); ++it) {
+    elements.push_back(*it);
+  }
+  EXPECT_EQ(elements, (std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+}
+
+TEST(AVLTreeCommon, InsertBatchSingleKey) {
+  AVL_tree_t<int> tree{1, 3, 5};
+  std::vector<int> batch{4};
+  tree.insert_batch(batch.begin(), batch.end());
+  tree.insert_batch(batch.begin(), batch.end());
+
+  EXPECT_EQ(tree.size(), 4);
+  EXPECT_EQ(*tree.lower_bound(4), 4);
+}
+
+TEST(AVLTreeCommon, InsertSortedBatch) {
+  AVL_tree_t<int> tree;
+  for (int i = 0; i < 1000; i += 10) {
+    tree.insert(i);
+  }
+
+  std::vector<int> small_batch{-3, 5, 10, 55, 995};  // Sorted, 10 is already in tree
+  tree.insert_sorted_batch(small_batch.begin(), small_batch.end());
+  EXPECT_EQ(tree.size(), 104);
+  EXPECT_EQ(tree.count_range(0, 10), 3);
+
+  std::vector<int> large_batch;
+  for (int i = 1; i < 1000; i += 2) {
+    large_batch.push_back(i);
+  }
+  tree.insert_sorted_batch(large_batch.begin(), large_batch.end());
+  EXPECT_EQ(tree.size(), 601);  // 5, 55 and 995 were inserted by small batch
+  EXPECT_EQ(tree.count_range(0, 20), 13);
+}
+
+TEST(AVLTreeCommon, InsertSortedBatchWithCustomComparator) {
+  AVL_tree_t<int, std::greater<int>> tree{10, 30};
+  std::vector<int> batch{40, 30, 20, 5, 1};
+  std::sort(batch.begin(), batch.end(), tree.key_comp());  // already in order of tree
+  tree.insert_sorted_batch(batch.begin(), batch.end());
+
+  std::vector<int> elements;
+  for (auto it = tree.begin(); it != tree.end(); ++it) {
+    elements.push_back(*it);
+  }
+  EXPECT_EQ(elements, (std::vector<int>{40, 30, 20, 10, 5, 1}));
+  EXPECT_EQ(tree.count_range(30, 5), 4);
+}
+
+TEST(AVLTreeCommon, OverflowingBatchLeavesTreeUnchanged) {
+  using narrow_tree_t = AVL_tree_t<int, std::less<int>, std::uint16_t>;
+  narrow_tree_t tree;
+  std::vector<int> batch;
+  for (int i = 0; i < static_cast<int>(narrow_tree_t::max_size()); ++i) {
+    if (i % 2 == 0) {
+      tree.insert(i);
+    } else {
+      batch.push_back(i + 1'000'000);
+    }
+  }
+  batch.push_back(-1);
+  batch.push_back(-2);
+
+  const std::size_t size = tree.size();
+  EXPECT_THROW(tree.insert_batch(batch.begin(), batch.end()), std::length_error);
+  EXPECT_EQ(tree.size(), size);
+  EXPECT_EQ(tree.count_range(0, 10), 6);
+}
+
+TEST(AVLTreeCommon, InsertBatchMatchesStdSet) {
+  compact_AVL_tree_t<int> tree;
+  std::set<int> etalon;
+
+  std::mt19937 rng(99);
+  for (int round = 0; round < 200; ++round) {
+    std::vector<int> batch(rng() % (round % 10 == 0 ? 3000 : 30));
+    for (int& key : batch) {
+      key = static_cast<int>(rng() % 100000);
+    }
+    tree.insert_batch(batch.begin(), batch.end());
+    etalon.insert(batch.begin(), batch.end());
+  }
+
+  std::vector<int> actual;
+  for (auto it = tree.begin(); it != tree.end(); ++it) {
+    actual.push_back(*it);
+  }
+  EXPECT_EQ(actual, std::vector<int>(etalon.begin(), etalon.end()));
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <set>
+
+#include "AVL/AVL_tree.hpp"
+
+namespace {
+
+template <typename TreeT>
+std::vector<int> collect_keys(const TreeT& tree) {
+  std::vector<int> keys;
+  for (auto it = tree.cbegin(); it != tree.cend(); ++it) {
+    keys.push_back(*it);
+  }
+
+  return keys;
+}
+
+}  // namespace
+
+TEST(AVLTreeErase, EraseFromEmptyTree) {
+  AVL_tree_t<int> tree;
+  EXPECT_EQ(tree.erase(42), 0);
+  EXPECT_TRUE(tree.empty());
+}
+
+TEST(AVLTreeErase, EraseMissingKey) {
+  AVL_tree_t<int> tree{1, 3, 5};
+  EXPECT_EQ(tree.erase(4), 0);
+  EXPECT_EQ(tree.erase(6), 0);
+  EXPECT_EQ(collect_keys(tree), (std::vector<int>{1, 3, 5}));
+}
+
+TEST(AVLTreeErase, EraseLeafAndInnerNodes) {
+  AVL_tree_t<int> tree{50, 30, 70, 20, 40, 60, 80};
+
+  EXPECT_EQ(tree.erase(20), 1);  // Leaf
+  EXPECT_EQ(collect_keys(tree), (std::vector<int>{30, 40, 50, 60, 70, 80}));
+
+  EXPECT_EQ(tree.erase(30), 1);  // Node with one son
+  EXPECT_EQ(collect_keys(tree), (std::vector<int>{40, 50, 60, 70, 80}));
+
+  EXPECT_EQ(tree.erase(50), 1);  // Root with two sons
+  EXPECT_EQ(collect_keys(tree), (std::vector<int>{40, 60, 70, 80}));
+  EXPECT_EQ(tree.size(), 4);
+}
+
+TEST(AVLTreeErase, EraseAllKeys) {
+  AVL_tree_t<int> tree{5, 3, 7, 1, 4};
+  for (int key : {3, 7, 5, 1, 4}) {
+    EXPECT_EQ(tree.erase(key), 1);
+  }
+
+  EXPECT_TRUE(tree.empty());
+  EXPECT_EQ(tree.begin(), tree.end());
+}
+
+TEST(AVLTreeErase, EraseByIteratorReturnsNext) {
+  AVL_tree_t<int> tree{1, 2, 3, 4, 5};
+
+  auto next_it = tree.erase(tree.lower_bound(2));
+  ASSERT_NE(next_it, tree.end());
+  EXPECT_EQ(*next_it, 3);
+
+  auto last_it = tree.erase(tree.lower_bound(5));
+  EXPECT_EQ(last_it, tree.end());
+
+  EXPECT_EQ(collect_keys(tree), (std::vector<int>{1, 3, 4}));
+}
+
+TEST(AVLTreeErase, OtherIteratorsStayValid) {
+  AVL_tree_t<int> tree{10, 5, 15, 3, 7, 12, 20};
+  auto it_7  = tree.lower_bound(7);
+  auto it_12 = tree.lower_bound(12);
+
+  tree.erase(10);  // Root, successor (12) is moved to its place
+
+  EXPECT_EQ(*it_7, 7);
+  EXPECT_EQ(*it_12, 12);
+  ++it_7;
+  EXPECT_EQ(*it_7, 12);
+}
+
+TEST(AVLTreeErase, InsertAfterErase) {
+  AVL_tree_t<int> tree{1, 2, 3};
+  tree.erase(2);
+  tree.insert(10);
+  tree.insert(2);
+
+  EXPECT_EQ(collect_keys(tree), (std::vector<int>{1, 2, 3, 10}));
+  EXPECT_EQ(tree.count_range(2, 10), 3);
+}
+
+TEST(AVLTreeErase, StringKeys) {
+  AVL_tree_t<std::string> tree{"apple", "banana", "cherry"};
+  EXPECT_EQ(tree.erase("banana"), 1);
+  tree.insert("date");
+
+  std::vector<std::string> elements;
+  for (auto it = tree.begin(); it != tree.end(); ++it) {
+    elements.push_back(*it);
+  }
+  EXPECT_EQ(elements, (std::vector<std::string>{"apple", "cherry", "date"}));
+}
+
+TEST(AVLTreeErase, RandomChurnMatchesStdSet) {
+  AVL_tree_t<int> tree;
+  std::set<int> etalon;
+
+  std::mt19937 rng(228);
+  for (int i = 0; i < 20000; ++i) {
+    int key = static_cast<int>(rng() % 500);
+    if (rng() % 2 == 0) {
+      tree.insert(key);
+      etalon.insert(key);
+    } else {
+      EXPECT_EQ(tree.erase(key), etalon.erase(key));
+    }
+
+    if (i % 1000 == 0) {
+      int low = static_cast<int>(rng() % 500);
+      int high = low + static_cast<int>(rng() % 100);
+      auto expected = std::distance(etalon.lower_bound(low), etalon.upper_bound(high));
+      EXPECT_EQ(tree.count_range(low, high), static_cast<std::size_t>(expected));
+    }
+  }
+
+  EXPECT_EQ(tree.size(), etalon.size());
+  EXPECT_EQ(collect_keys(tree), std::vector<int>(etalon.begin(), etalon.end()));
+}
+
+// erased slots go to free list and are reused, so arena doesn't grow beyond peak number of keys
+TEST(AVLTreeErase, ChurnReusesFreedSlots) {
+  constexpr std::size_t kPeakSize = 1000;
+  AVL_tree_t<int> tree;
+  std::vector<int> keys;
+  for (std::size_t i = 0; i < kPeakSize; ++i) {
+    keys.push_back(static_cast<int>(i));
+    tree.insert(keys.back());
+  }
+  const std::size_t peak_nodes_count = tree.stats().nodes_count;
+  EXPECT_EQ(peak_nodes_count, kPeakSize + 1); // null node
+
+  std::mt19937 rng(1337);
+  int next_key = static_cast<int>(kPeakSize);
+  for (int round = 0; round < 100; ++round) {
+    std::shuffle(keys.begin(), keys.end(), rng);
+    for (std::size_t i = 0; i < kPeakSize / 2; ++i) {
+      EXPECT_EQ(tree.erase(keys[i]), 1);
+      keys[i] = next_key++;
+    }
+    EXPECT_EQ(tree.stats().free_nodes, kPeakSize / 2);
+
+    for (std::size_t i = 0; i < kPeakSize / 2; ++i) {
+      tree.insert(keys[i]);
+    }
+    EXPECT_EQ(tree.size(), kPeakSize);
+    EXPECT_EQ(tree.stats().nodes_count, peak_nodes_count);
+    EXPECT_EQ(tree.stats().free_nodes, 0);
+  }
+}
@@ -198,4 +198,52 @@ TEST(AVLTreeIterator, ComplexTreeStructure) {
   // Verify all elements are present
   std::vector<int> expected{5, 10, 15, 25, 27, 30, 50, 55, 60, 75, 80};
   EXPECT_EQ(elements, expected);
-}
\ No newline at end of file
+}
+
+TEST(AVLTreeIterator, Select) {
+  AVL_tree_t<int> tree{50, 10, 40, 20, 30};
+
+  EXPECT_EQ(*tree.select(0), 10);
+  EXPECT_EQ(*tree.select(2), 30);
+  EXPECT_EQ(*tree.select(4), 50);
+  EXPECT_EQ(tree.select(5), tree.end());
+  EXPECT_EQ(*tree.nth_element(3), 40);
+}
+
+TEST(AVLTreeIterator, SelectConst) {
+  const AVL_tree_t<int> tree{3, 1, 2};
+
+  EXPECT_EQ(*tree.select(0), 1);
+  EXPECT_EQ(*tree.select(1), 2);
+  EXPECT_EQ(tree.select(3), tree.cend());
+}
+
+TEST(AVLTreeIterator, JumpForwardAndBackward) {
+  AVL_tree_t<int> tree;
+  for (int i = 0; i < 1000; ++i) {
+    tree.insert(i * 2);
+  }
+
+  auto it = tree.begin() + 100;
+  EXPECT_EQ(*it, 200);
+  it += 399;
+  EXPECT_EQ(*it, 998);
+  it -= 250;
+  EXPECT_EQ(*it, 498);
+  EXPECT_EQ(*(it - 249), 0);
+  EXPECT_EQ(it + 751, tree.end());
+  EXPECT_EQ(*(tree.end() - 1), 1998);
+}
+
+TEST(AVLTreeIterator, JumpMatchesIncrement) {
+  AVL_tree_t<int> tree{8, 3, 10, 1, 6, 14, 4, 7, 13};
+  auto begin = tree.begin();
+
+  auto stepped = tree.begin();
+  for (std::ptrdiff_t offset = 0; offset <= 9; ++offset) {
+    EXPECT_EQ(begin + offset, stepped);
+    if (stepped != tree.end()) {
+      ++stepped;
+    }
+  }
+}
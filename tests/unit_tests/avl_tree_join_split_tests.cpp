@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <set>
+
+#include "AVL/AVL_tree.hpp"
+
+namespace {
+
+template <typename TreeT>
+std::vector<int> collect_keys(const TreeT& tree) {
+  std::vector<int> keys;
+  for (auto it = tree.cbegin(); it != tree.cend(); ++it) {
+    keys.push_back(*it);
+  }
+
+  return keys;
+}
+
+std::vector<int> make_range(int low, int high) {
+  std::vector<int> keys;
+  for (int key = low; key < high; ++key) {
+    keys.push_back(key);
+  }
+
+  return keys;
+}
+
+}  // namespace
+
+TEST(AVLTreeJoinSplit, JoinTreesOfDifferentHeights) {
+  std::vector<int> small_keys = make_range(0, 3);
+  std::vector<int> large_keys = make_range(4, 1000);
+  AVL_tree_t<int> left(small_keys.begin(), small_keys.end());
+  AVL_tree_t<int> right(large_keys.begin(), large_keys.end());
+
+  AVL_tree_t<int> joined = AVL_tree_t<int>::join(std::move(left), 3, std::move(right));
+
+  EXPECT_EQ(collect_keys(joined), make_range(0, 1000));
+  EXPECT_EQ(joined.count_range(100, 199), 100);
+  EXPECT_TRUE(left.empty());
+  EXPECT_TRUE(right.empty());
+}
+
+TEST(AVLTreeJoinSplit, JoinWithEmptyTrees) {
+  AVL_tree_t<int> empty_left;
+  AVL_tree_t<int> empty_right;
+  AVL_tree_t<int> single = AVL_tree_t<int>::join(std::move(empty_left), 5, std::move(empty_right));
+  EXPECT_EQ(collect_keys(single), (std::vector<int>{5}));
+
+  AVL_tree_t<int> right{7, 8, 9, 10, 11, 12};
+  AVL_tree_t<int> joined = AVL_tree_t<int>::join(std::move(single), 6, std::move(right));
+  EXPECT_EQ(collect_keys(joined), (std::vector<int>{5, 6, 7, 8, 9, 10, 11, 12}));
+}
+
+TEST(AVLTreeJoinSplit, SplitByKey) {
+  AVL_tree_t<int> tree{1, 3, 5, 7, 9, 11};
+
+  AVL_tree_t<int> upper = tree.split(6);
+  EXPECT_EQ(collect_keys(tree),  (std::vector<int>{1, 3, 5}));
+  EXPECT_EQ(collect_keys(upper), (std::vector<int>{7, 9, 11}));
+
+  // key itself goes to the returned tree
+  AVL_tree_t<int> top = upper.split(9);
+  EXPECT_EQ(collect_keys(upper), (std::vector<int>{7}));
+  EXPECT_EQ(collect_keys(top),   (std::vector<int>{9, 11}));
+}
+
+TEST(AVLTreeJoinSplit, SplitOutsideOfKeys) {
+  AVL_tree_t<int> tree{1, 2, 3};
+
+  AVL_tree_t<int> everything = tree.split(-100);
+  EXPECT_TRUE(tree.empty());
+  EXPECT_EQ(collect_keys(everything), (std::vector<int>{1, 2, 3}));
+
+  AVL_tree_t<int> nothing = everything.split(100);
+  EXPECT_TRUE(nothing.empty());
+  EXPECT_EQ(collect_keys(everything), (std::vector<int>{1, 2, 3}));
+}
+
+TEST(AVLTreeJoinSplit, TreesStayUsableAfterSplit) {
+  std::vector<int> keys = make_range(0, 500);
+  AVL_tree_t<int> tree(keys.begin(), keys.end());
+  AVL_tree_t<int> upper = tree.split(100);
+
+  tree.insert(1000);
+  upper.insert(-1);
+  EXPECT_EQ(tree.erase(50), 1);
+  EXPECT_EQ(upper.erase(300), 1);
+
+  EXPECT_EQ(tree.size(), 100);
+  EXPECT_EQ(upper.size(), 400);
+  EXPECT_EQ(tree.count_range(0, 99), 99);
+  EXPECT_EQ(upper.count_less(100), 1);
+}
+
+TEST(AVLTreeJoinSplit, MergeDisjointTrees) {
+  AVL_tree_t<int> tree{10, 11, 12};
+  AVL_tree_t<int> lower{1, 2, 3, 4, 5};
+  AVL_tree_t<int> upper{20};
+
+  tree.merge(std::move(lower));
+  tree.merge(std::move(upper));
+
+  EXPECT_EQ(collect_keys(tree), (std::vector<int>{1, 2, 3, 4, 5, 10, 11, 12, 20}));
+  EXPECT_TRUE(lower.empty());
+  EXPECT_TRUE(upper.empty());
+}
+
+TEST(AVLTreeJoinSplit, MergeOverlappingTrees) {
+  AVL_tree_t<int> tree{1, 5, 9};
+  AVL_tree_t<int> other{2, 5, 8, 12};
+
+  tree.merge(std::move(other));
+
+  EXPECT_EQ(collect_keys(tree), (std::vector<int>{1, 2, 5, 8, 9, 12}));
+  EXPECT_TRUE(other.empty());
+}
+
+TEST(AVLTreeJoinSplit, MoveRangesBetweenTreesMatchesStdSet) {
+  std::mt19937 rng(31);
+  std::uniform_int_distribution<int> key_dist(-5000, 5000);
+
+  compact_AVL_tree_t<int> first;
+  compact_AVL_tree_t<int> second;
+  std::set<int> first_set;
+  std::set<int> second_set;
+  for (int i = 0; i < 3000; ++i) {
+    int key = key_dist(rng);
+    first.insert(key);
+    first_set.insert(key);
+  }
+
+  for (int round = 0; round < 50; ++round) {
+    // move keys in [low, high) from first tree to second one
+    int low  = key_dist(rng);
+    int high = low + 500;
+    compact_AVL_tree_t<int> moved = first.split(low);
+    compact_AVL_tree_t<int> rest  = moved.split(high);
+    first.merge(std::move(rest));
+    second.merge(std::move(moved));
+
+    second_set.insert(first_set.lower_bound(low), first_set.lower_bound(high));
+    first_set.erase(first_set.lower_bound(low), first_set.lower_bound(high));
+
+    int key = key_dist(rng);
+    first.erase(key);
+    first_set.erase(key);
+    first.insert(key + 1);
+    first_set.insert(key + 1);
+
+    ASSERT_EQ(collect_keys(first),  std::vector<int>(first_set.begin(),  first_set.end()));
+    ASSERT_EQ(collect_keys(second), std::vector<int>(second_set.begin(), second_set.end()));
+  }
+}
@@ -1,5 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
 #include "AVL/AVL_tree.hpp"
 
 TEST(AVLTreeBounds, LowerBoundBasic) {
@@ -235,3 +241,127 @@ TEST(AVLTreeBounds, IteratorValidity) {
   EXPECT_EQ(*lb_before, 5);  // Should still point to 5
   EXPECT_EQ(*ub_before, 5);  // Should still point to 5
 }
+
+TEST(AVLTreeBounds, CountLess) {
+  AVL_tree_t<int> tree{1, 3, 5, 7, 9};
+
+  EXPECT_EQ(tree.count_less(0), 0);
+  EXPECT_EQ(tree.count_less(1), 0);
+  EXPECT_EQ(tree.count_less(2), 1);
+  EXPECT_EQ(tree.count_less(5), 2);
+  EXPECT_EQ(tree.count_less(9), 4);
+  EXPECT_EQ(tree.count_less(10), 5);
+}
+
+TEST(AVLTreeBounds, CountRange) {
+  AVL_tree_t<int> tree{1, 3, 5, 7, 9};
+
+  EXPECT_EQ(tree.count_range(1, 9), 5);  // Whole tree
+  EXPECT_EQ(tree.count_range(3, 7), 3);  // Bounds are inclusive
+  EXPECT_EQ(tree.count_range(2, 8), 3);
+  EXPECT_EQ(tree.count_range(4, 4), 0);  // Between elements
+  EXPECT_EQ(tree.count_range(5, 5), 1);  // Single element
+  EXPECT_EQ(tree.count_range(10, 20), 0);  // After last
+  EXPECT_EQ(tree.count_range(7, 3), 0);  // Empty range
+}
+
+TEST(AVLTreeBounds, CountRangeEmptyTree) {
+  AVL_tree_t<int> tree;
+  EXPECT_EQ(tree.count_range(-5, 5), 0);
+  EXPECT_EQ(tree.count_less(42), 0);
+}
+
+TEST(AVLTreeBounds, CountRangeMatchesIteratorDistance) {
+  AVL_tree_t<int> tree;
+  for (int i = 0; i < 1000; i += 3) {
+    tree.insert(i);
+  }
+
+  for (int low = -10; low < 1010; low += 7) {
+    for (int high = low; high < 1010; high += 11) {
+      std::size_t distance = tree.upper_bound(high) - tree.lower_bound(low);
+      EXPECT_EQ(tree.count_range(low, high), distance);
+    }
+  }
+}
+
+namespace {
+
+// the same order as std::less<int>, but search can't be specialized for it
+struct generic_less_t {
+  bool operator()(int lhs, int rhs) const { return lhs < rhs; }
+};
+
+} // namespace
+
+TEST(AVLTreeBounds, BranchFreeSearchMatchesGenericSearch) {
+  std::vector<int> keys;
+  for (int i = 0; i < 2000; ++i) {
+    keys.push_back((i * 7919) % 3001 - 1500);
+  }
+  compact_AVL_tree_t<int>                 branch_free_tree(keys.begin(), keys.end());
+  soa_AVL_tree_t<int, std::less<>>        branch_free_soa_tree(keys.begin(), keys.end());
+  compact_AVL_tree_t<int, generic_less_t> generic_tree(keys.begin(), keys.end());
+
+  for (int key = -1600; key <= 1600; ++key) {
+    auto generic_lower = generic_tree.lower_bound(key);
+    auto generic_upper = generic_tree.upper_bound(key);
+    int expected_lower = generic_lower == generic_tree.end() ? INT32_MAX : *generic_lower;
+    int expected_upper = generic_upper == generic_tree.end() ? INT32_MAX : *generic_upper;
+
+    auto lower = branch_free_tree.lower_bound(key);
+    auto upper = branch_free_tree.upper_bound(key);
+    EXPECT_EQ(lower == branch_free_tree.end() ? INT32_MAX : *lower, expected_lower);
+    EXPECT_EQ(upper == branch_free_tree.end() ? INT32_MAX : *upper, expected_upper);
+
+    auto soa_lower = branch_free_soa_tree.lower_bound(key);
+    EXPECT_EQ(soa_lower == branch_free_soa_tree.end() ? INT32_MAX : *soa_lower, expected_lower);
+
+    EXPECT_EQ(branch_free_tree.count_less(key), generic_tree.count_less(key));
+    EXPECT_EQ(branch_free_tree.count_range(key, key + 100), generic_tree.count_range(key, key + 100));
+    EXPECT_EQ(branch_free_soa_tree.count_range(key, key + 100), generic_tree.count_range(key, key + 100));
+  }
+}
+
+namespace {
+
+template <typename TreeT>
+void expect_batch_matches_single(const TreeT& tree, const std::vector<int>& keys) {
+  std::vector<typename TreeT::const_iterator> lower_bounds;
+  tree.lower_bound_batch(keys.begin(), keys.end(), std::back_inserter(lower_bounds));
+  ASSERT_EQ(lower_bounds.size(), keys.size());
+
+  std::vector<std::pair<int, int>> ranges;
+  for (std::size_t key_ind = 0; key_ind < keys.size(); ++key_ind) {
+    ranges.emplace_back(keys[key_ind], keys[keys.size() - 1 - key_ind]); // some of them are empty
+  }
+  std::vector<std::size_t> counts;
+  tree.count_range_batch(ranges.begin(), ranges.end(), std::back_inserter(counts));
+  ASSERT_EQ(counts.size(), ranges.size());
+
+  for (std::size_t key_ind = 0; key_ind < keys.size(); ++key_ind) {
+    EXPECT_TRUE(lower_bounds[key_ind] == tree.lower_bound(keys[key_ind]));
+    EXPECT_EQ(counts[key_ind], tree.count_range(ranges[key_ind].first, ranges[key_ind].second));
+  }
+}
+
+} // namespace
+
+TEST(AVLTreeBounds, BatchSearchMatchesSingleSearch) {
+  std::vector<int> tree_keys;
+  for (int i = 0; i < 2000; ++i) {
+    tree_keys.push_back((i * 7919) % 3001 - 1500);
+  }
+  // group of lanes is not full at the end
+  std::vector<int> keys;
+  for (int key = -1600; key <= 1600; key += 3) {
+    keys.push_back(key);
+  }
+
+  expect_batch_matches_single(compact_AVL_tree_t<int>(tree_keys.begin(), tree_keys.end()), keys);
+  expect_batch_matches_single(soa_AVL_tree_t<int>(tree_keys.begin(), tree_keys.end()), keys);
+  expect_batch_matches_single(compact_AVL_tree_t<int, generic_less_t>(tree_keys.begin(), tree_keys.end()), keys);
+  expect_batch_matches_single(AVL_tree_t<int>(), keys);
+  expect_batch_matches_single(AVL_tree_t<int>{5}, std::vector<int>{4, 5, 6});
+  expect_batch_matches_single(AVL_tree_t<int>{5}, std::vector<int>{});
+}
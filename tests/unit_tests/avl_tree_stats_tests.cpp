@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "AVL/AVL_tree.hpp"
+
+// built with AVL_COUNTERS_, see CMakeLists.txt
+
+TEST(AVLTreeStats, EmptyTree) {
+  AVL_tree_t<int> tree;
+  const AVL_tree_stats_t stats = tree.stats();
+  EXPECT_EQ(stats.size, 0);
+  EXPECT_EQ(stats.height, 0);
+  EXPECT_TRUE(stats.depth_histogram.empty());
+  EXPECT_EQ(stats.average_search_depth, 0.0);
+  EXPECT_EQ(stats.free_nodes, 0);
+  EXPECT_TRUE(stats.are_counters_enabled);
+  EXPECT_EQ(stats.rotations_per_insert(), 0.0);
+}
+
+TEST(AVLTreeStats, DepthHistogramOfPerfectTree) {
+  std::vector<int> keys(7);
+  std::iota(keys.begin(), keys.end(), 0);
+  compact_AVL_tree_t<int> tree(keys.begin(), keys.end());
+
+  const AVL_tree_stats_t stats = tree.stats();
+  EXPECT_EQ(stats.size, 7);
+  EXPECT_EQ(stats.height, 3);
+  EXPECT_EQ(stats.depth_histogram, std::vector<std::size_t>({1, 2, 4}));
+  EXPECT_DOUBLE_EQ(stats.average_search_depth, (1.0 * 1 + 2.0 * 2 + 3.0 * 4) / 7);
+  // bulk build doesn't insert keys one by one
+  EXPECT_EQ(stats.counters.inserted_nodes, 0);
+  EXPECT_EQ(stats.counters.left_rotations + stats.counters.right_rotations, 0);
+}
+
+TEST(AVLTreeStats, MemoryFootprint) {
+  compact_AVL_tree_t<int> compact_tree{1, 2, 3};
+  soa_AVL_tree_t<int>     soa_tree{1, 2, 3};
+
+  for (const AVL_tree_stats_t& stats : {compact_tree.stats(), soa_tree.stats()}) {
+    EXPECT_EQ(stats.nodes_count, 4); // null node and 3 keys
+    EXPECT_GE(stats.nodes_capacity, stats.nodes_count);
+    EXPECT_EQ(stats.memory_bytes, stats.nodes_capacity * stats.node_bytes);
+    EXPECT_DOUBLE_EQ(stats.bytes_per_key, stats.memory_bytes / 3.0);
+  }
+  // key, two sons, parent and packed height with size
+  EXPECT_EQ(compact_tree.stats().node_bytes, sizeof(int) + 4 * sizeof(std::uint32_t));
+  // key, two sons, size, parent and height
+  EXPECT_EQ(soa_tree.stats().node_bytes, sizeof(int) + 4 * sizeof(std::uint32_t) + sizeof(std::int8_t));
+}
+
+TEST(AVLTreeStats, SortedInsertionsRotateLeft) {
+  AVL_tree_t<int> tree;
+  for (int key = 0; key < 1023; ++key) {
+    tree.insert(key);
+  }
+  tree.insert(5); // duplicate doesn't create node
+
+  const AVL_tree_stats_t stats = tree.stats();
+  EXPECT_EQ(stats.height, 10);
+  EXPECT_EQ(stats.counters.inserted_nodes, 1023);
+  EXPECT_EQ(stats.counters.right_rotations, 0);
+  EXPECT_EQ(stats.counters.left_rotations, stats.counters.rebalances);
+  // n - log2(n + 1) single rotations build perfect tree from sorted keys
+  EXPECT_EQ(stats.counters.left_rotations, 1023 - 10);
+  EXPECT_NEAR(stats.rotations_per_insert(), 1.0, 0.01);
+}
+
+TEST(AVLTreeStats, ErasedNodesAreFreeSlots) {
+  AVL_tree_t<int> tree;
+  for (int key = 0; key < 100; ++key) {
+    tree.insert(key);
+  }
+  for (int key = 0; key < 100; key += 2) {
+    tree.erase(key);
+  }
+
+  const AVL_tree_stats_t stats = tree.stats();
+  EXPECT_EQ(stats.size, 50);
+  EXPECT_EQ(stats.free_nodes, 50);
+  EXPECT_EQ(stats.counters.freed_nodes, 50);
+
+  std::size_t keys_in_histogram = 0;
+  for (std::size_t count : stats.depth_histogram) {
+    keys_in_histogram += count;
+  }
+  EXPECT_EQ(keys_in_histogram, 50);
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "fenwick/fenwick_tree.hpp"
+
+TEST(FenwickTree, EmptyTree) {
+  fenwick_tree_t<> tree;
+  EXPECT_EQ(tree.size(), 0);
+  EXPECT_EQ(tree.prefix_sum(0), 0);
+}
+
+TEST(FenwickTree, PointUpdatesAndPrefixSums) {
+  fenwick_tree_t<int> tree(5);
+  tree.add(0, 3);
+  tree.add(2, 5);
+  tree.add(4, -1);
+
+  EXPECT_EQ(tree.prefix_sum(0), 0);
+  EXPECT_EQ(tree.prefix_sum(1), 3);
+  EXPECT_EQ(tree.prefix_sum(3), 8);
+  EXPECT_EQ(tree.prefix_sum(5), 7);
+  EXPECT_EQ(tree.range_sum(1, 3), 5);
+  EXPECT_EQ(tree.range_sum(3, 1), 0);
+}
+
+TEST(FenwickTree, UnsignedCountersWithDecrements) {
+  fenwick_tree_t<> tree(3);
+  tree.add(0, 1);
+  tree.add(1, 1);
+  tree.add(0, static_cast<std::size_t>(-1));
+
+  EXPECT_EQ(tree.range_sum(0, 3), 1);
+  EXPECT_EQ(tree.range_sum(1, 2), 1);
+}
+
+TEST(FenwickTree, MatchesNaiveSums) {
+  std::mt19937 rng(17);
+  const std::size_t size = 1000;
+  fenwick_tree_t<long long> tree(size);
+  std::vector<long long> values(size);
+
+  for (int step = 0; step < 10000; ++step) {
+    std::size_t position = rng() % size;
+    long long delta = static_cast<long long>(rng() % 201) - 100;
+    tree.add(position, delta);
+    values[position] += delta;
+
+    std::size_t begin = rng() % (size + 1);
+    std::size_t end   = rng() % (size + 1);
+    long long expected = 0;
+    for (std::size_t i = begin; i < end; ++i) {
+      expected += values[i];
+    }
+    ASSERT_EQ(tree.range_sum(begin, end), expected);
+  }
+}
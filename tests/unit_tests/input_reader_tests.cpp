@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <unistd.h>
+
+#include "solutions/input_reader.hpp"
+
+namespace {
+
+// input_reader_t works with file descriptors, so data is passed through temporary file
+class temp_input_t {
+ public:
+  explicit temp_input_t(const std::string& data) : file_(std::tmpfile()) {
+    std::fwrite(data.data(), 1, data.size(), file_);
+    std::fflush(file_);
+    std::rewind(file_);
+  }
+
+  ~temp_input_t() { std::fclose(file_); }
+
+  int fd() const { return fileno(file_); }
+
+ private:
+  std::FILE* file_;
+};
+
+}  // namespace
+
+TEST(InputReader, ReadsQueryStream) {
+  temp_input_t input("k 10\nk -20\tq +8 31 \r\n");
+  solution::input_reader_t reader(input.fd());
+
+  char query_type{};
+  int  number{};
+  EXPECT_TRUE(reader.read(query_type)); EXPECT_EQ(query_type, 'k');
+  EXPECT_TRUE(reader.read(number));     EXPECT_EQ(number, 10);
+  EXPECT_TRUE(reader.read(query_type)); EXPECT_EQ(query_type, 'k');
+  EXPECT_TRUE(reader.read(number));     EXPECT_EQ(number, -20);
+  EXPECT_TRUE(reader.read(query_type)); EXPECT_EQ(query_type, 'q');
+  EXPECT_TRUE(reader.read(number));     EXPECT_EQ(number, 8);
+  EXPECT_TRUE(reader.read(number));     EXPECT_EQ(number, 31);
+
+  EXPECT_FALSE(reader.read(query_type));
+  EXPECT_TRUE(reader.eof());
+  EXPECT_FALSE(reader.fail());
+}
+
+TEST(InputReader, InvalidNumber) {
+  temp_input_t input("k abc");
+  solution::input_reader_t reader(input.fd());
+
+  char query_type{};
+  int  number{};
+  EXPECT_TRUE(reader.read(query_type));
+  EXPECT_FALSE(reader.read(number));
+  EXPECT_TRUE(reader.fail());
+}
+
+TEST(InputReader, NumbersAcrossBlockBoundaries) {
+  // a few megabytes, so that many numbers are cut by the ends of read blocks
+  std::string data;
+  long long expected_sum = 0;
+  for (int number = -300000; number < 300000; number += 3) {
+    data += "k " + std::to_string(number) + "\n";
+    expected_sum += number;
+  }
+  temp_input_t input(data);
+  solution::input_reader_t reader(input.fd());
+
+  char query_type{};
+  int  number{};
+  long long sum = 0;
+  int count = 0;
+  while (reader.read(query_type)) {
+    ASSERT_EQ(query_type, 'k');
+    ASSERT_TRUE(reader.read(number));
+    sum += number;
+    ++count;
+  }
+
+  EXPECT_EQ(count, 200000);
+  EXPECT_EQ(sum, expected_sum);
+}
+
+TEST(InputReader, MappedFile) {
+  char file_path[] = "/tmp/input_reader_testXXXXXX";
+  int fd = mkstemp(file_path);
+  ASSERT_GE(fd, 0);
+  const std::string data = "k 10 k 20 q 8 31";
+  ASSERT_EQ(write(fd, data.data(), data.size()), static_cast<ssize_t>(data.size()));
+  close(fd);
+
+  {
+    solution::input_reader_t reader(static_cast<const char*>(file_path));
+    char query_type{};
+    int  sum = 0;
+    int  number{};
+    while (reader.read(query_type)) {
+      int numbers_cnt = query_type == 'q' ? 2 : 1;
+      for (int i = 0; i < numbers_cnt; ++i) {
+        ASSERT_TRUE(reader.read(number));
+        sum += number;
+      }
+    }
+
+    EXPECT_EQ(sum, 10 + 20 + 8 + 31);
+    EXPECT_TRUE(reader.eof());
+  }
+  unlink(file_path);
+}
+
+TEST(InputReader, MissingFile) {
+  solution::input_reader_t reader("/nonexistent/input_reader_test");
+  char query_type{};
+  EXPECT_TRUE(reader.fail());
+  EXPECT_FALSE(reader.read(query_type));
+}
+
+TEST(InputReader, BinaryQueryLog) {
+  // header: magic, version 1, signed keys of 2 bytes, 3 queries
+  std::string data("AVLQ\x01\x00\x02\x00\x03\x00\x00\x00\x00\x00\x00\x00", 16);
+  data += std::string("k\x0a\x00", 3);          // k 10
+  data += std::string("d\xfe\xff", 3);          // d -2
+  data += std::string("q\x00\x80\xff\x7f", 5);  // q -32768 32767
+  temp_input_t input(data);
+  solution::input_reader_t reader(input.fd());
+  EXPECT_TRUE(reader.is_binary());
+  EXPECT_EQ(reader.binary_query_count(), 3);
+
+  char query_type{};
+  int  number{};
+  EXPECT_TRUE(reader.read(query_type)); EXPECT_EQ(query_type, 'k');
+  EXPECT_TRUE(reader.read(number));     EXPECT_EQ(number, 10);
+  EXPECT_TRUE(reader.read(query_type)); EXPECT_EQ(query_type, 'd');
+  EXPECT_TRUE(reader.read(number));     EXPECT_EQ(number, -2);
+  EXPECT_TRUE(reader.read(query_type)); EXPECT_EQ(query_type, 'q');
+  EXPECT_TRUE(reader.read(number));     EXPECT_EQ(number, -32768);
+  EXPECT_TRUE(reader.read(number));     EXPECT_EQ(number, 32767);
+  EXPECT_FALSE(reader.read(query_type));
+  EXPECT_FALSE(reader.fail());
+}
+
+TEST(InputReader, BinaryKeyOutOfRange) {
+  // unsigned keys of 8 bytes, key doesn't fit into int
+  std::string data("AVLQ\x01\x01\x08\x00\x01\x00\x00\x00\x00\x00\x00\x00", 16);
+  data += std::string("k\x00\x00\x00\x00\x01\x00\x00\x00", 9);
+  temp_input_t input(data);
+  solution::input_reader_t reader(input.fd());
+
+  char query_type{};
+  int  number{};
+  EXPECT_TRUE(reader.read(query_type));
+  EXPECT_FALSE(reader.read(number));
+  EXPECT_TRUE(reader.fail());
+}
+
+TEST(InputReader, BinaryUnsupportedHeader) {
+  // key width 3 is not allowed
+  std::string data("AVLQ\x01\x00\x03\x00\x00\x00\x00\x00\x00\x00\x00\x00", 16);
+  temp_input_t input(data);
+  solution::input_reader_t reader(input.fd());
+
+  char query_type{};
+  EXPECT_TRUE(reader.fail());
+  EXPECT_FALSE(reader.read(query_type));
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+
+#include "solutions/latency_histogram.hpp"
+
+TEST(LatencyHistogram, EmptyHistogram) {
+  solution::latency_histogram_t histogram;
+  EXPECT_EQ(histogram.count(), 0);
+  EXPECT_EQ(histogram.max(), 0);
+  EXPECT_EQ(histogram.percentile(50), 0);
+}
+
+TEST(LatencyHistogram, SmallValuesAreExact) {
+  solution::latency_histogram_t histogram;
+  for (std::uint64_t value = 1; value <= 10; ++value) {
+    histogram.record(value);
+  }
+
+  EXPECT_EQ(histogram.count(), 10);
+  EXPECT_EQ(histogram.max(), 10);
+  EXPECT_EQ(histogram.percentile(0),   1);
+  EXPECT_EQ(histogram.percentile(50),  5);
+  EXPECT_EQ(histogram.percentile(90),  9);
+  EXPECT_EQ(histogram.percentile(100), 10);
+}
+
+TEST(LatencyHistogram, LargeValuesHaveBoundedRelativeError) {
+  solution::latency_histogram_t histogram;
+  for (std::uint64_t value = 1000; value <= 1'000'000; value += 1000) {
+    histogram.record(value);
+  }
+
+  for (double percent : {10.0, 50.0, 99.0, 99.9}) {
+    const double expected = 1000.0 * static_cast<std::uint64_t>(percent * 10 + 0.5);
+    const auto actual = static_cast<double>(histogram.percentile(percent));
+    EXPECT_GE(actual, expected);
+    EXPECT_LE(actual, expected * (1.0 + 1.0 / 16));
+  }
+  EXPECT_EQ(histogram.percentile(100), 1'000'000);
+}
+
+TEST(LatencyHistogram, TailIsSeparatedFromBody) {
+  solution::latency_histogram_t histogram;
+  for (int i = 0; i < 999; ++i) {
+    histogram.record(100);
+  }
+  histogram.record(UINT64_MAX);
+
+  EXPECT_LE(histogram.percentile(99),  106);
+  EXPECT_EQ(histogram.percentile(100), UINT64_MAX);
+  EXPECT_EQ(histogram.max(), UINT64_MAX);
+}
+
+TEST(LatencyHistogram, PrintsJson) {
+  solution::latency_histogram_t histogram;
+  histogram.record(7);
+
+  std::ostringstream out;
+  histogram.print_json(out);
+  EXPECT_EQ(out.str(), "{\"count\": 1, \"max\": 7, \"p50\": 7, \"p90\": 7, \"p99\": 7, \"p999\": 7, \"p9999\": 7}");
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "AVL/AVL_tree.hpp"
+#include "concurrent/left_right_tree.hpp"
+
+using tree_t = left_right_tree_t<compact_AVL_tree_t<int>>;
+
+TEST(LeftRightTree, SingleThreadUpdatesAndQueries) {
+  tree_t tree;
+  EXPECT_EQ(tree.size(), 0);
+  EXPECT_EQ(tree.lower_bound(5), std::nullopt);
+
+  tree.insert(10);
+  tree.insert(20);
+  tree.insert(30);
+  tree.insert(20);
+  EXPECT_EQ(tree.size(), 3);
+  EXPECT_EQ(tree.count_range(15, 30), 2);
+  EXPECT_EQ(tree.lower_bound(11), 20);
+
+  tree.erase(20);
+  EXPECT_EQ(tree.size(), 2);
+  EXPECT_EQ(tree.count_range(15, 30), 1);
+  EXPECT_EQ(tree.lower_bound(11), 30);
+  EXPECT_EQ(tree.lower_bound(31), std::nullopt);
+}
+
+TEST(LeftRightTree, ConstructedFromTree) {
+  tree_t tree(compact_AVL_tree_t<int>{5, 1, 3});
+  tree.insert(2);
+  EXPECT_EQ(tree.count_range(1, 5), 4);
+}
+
+TEST(LeftRightTree, ReadSeesConsistentVersion) {
+  tree_t tree;
+  tree.modify([](compact_AVL_tree_t<int>& copy) {
+    for (int key = 0; key < 100; ++key) {
+      copy.insert(key);
+    }
+  });
+
+  std::size_t tree_size = tree.read([](const compact_AVL_tree_t<int>& copy) {
+    return copy.size();
+  });
+  EXPECT_EQ(tree_size, 100);
+  EXPECT_EQ(tree.count_range(0, 99), 100);
+}
+
+// writer inserts keys 0, 1, 2, ... in increasing order until readers are done, so every
+// published version is prefix {0, ..., size - 1}, readers check that nothing else is ever observed
+TEST(LeftRightTree, ReadersSeeOnlyPublishedVersions) {
+  const std::size_t reads_per_reader = 2000;
+  const std::size_t readers_count    = 4;
+
+  tree_t tree;
+  std::atomic<std::size_t> done_readers_count{0};
+  std::atomic<std::size_t> errors_count{0};
+
+  std::vector<std::thread> readers;
+  for (std::size_t reader_ind = 0; reader_ind < readers_count; ++reader_ind) {
+    readers.emplace_back([&, reader_ind]() {
+      std::size_t prev_size = 0;
+      for (std::size_t read_ind = 0; read_ind < reads_per_reader; ++read_ind) {
+        tree.read([&](const compact_AVL_tree_t<int>& copy) {
+          const std::size_t size = copy.size();
+          const int probe_key = static_cast<int>((read_ind * 7 + reader_ind) % (size + 2));
+          const std::size_t expected_count = std::min<std::size_t>(size, probe_key + 1);
+          if (size < prev_size || copy.count_range(0, probe_key) != expected_count) {
+            ++errors_count;
+          }
+          prev_size = size;
+        });
+      }
+      ++done_readers_count;
+    });
+  }
+
+  int keys_count = 0;
+  while (done_readers_count.load() < readers_count) {
+    tree.insert(keys_count++);
+  }
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(errors_count.load(), 0);
+  EXPECT_EQ(tree.size(), keys_count);
+}
+
+TEST(LeftRightTree, ConcurrentWriters) {
+  const int keys_per_writer = 5000;
+  const int writers_count = 3;
+
+  tree_t tree;
+  std::vector<std::thread> writers;
+  for (int writer_ind = 0; writer_ind < writers_count; ++writer_ind) {
+    writers.emplace_back([&tree, writer_ind]() {
+      for (int key = 0; key < keys_per_writer; ++key) {
+        tree.insert(key * writers_count + writer_ind);
+      }
+    });
+  }
+  for (std::thread& writer : writers) {
+    writer.join();
+  }
+
+  EXPECT_EQ(tree.size(), keys_per_writer * writers_count);
+  EXPECT_EQ(tree.count_range(0, keys_per_writer * writers_count - 1), keys_per_writer * writers_count);
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+#include "solutions/output_writer.hpp"
+
+namespace {
+
+std::string read_whole_file(std::FILE* file) {
+  std::rewind(file);
+  std::string content;
+  char buffer[4096];
+  std::size_t read_size = 0;
+  while ((read_size = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    content.append(buffer, read_size);
+  }
+
+  return content;
+}
+
+}  // namespace
+
+TEST(OutputWriter, WritesNumbersWithSeparators) {
+  std::FILE* file = std::tmpfile();
+  {
+    solution::output_writer_t writer(fileno(file));
+    writer.write(2);
+    writer.write(0);
+    writer.write(std::size_t{18446744073709551615ull});
+    writer.write(-7, '\n');
+  }  // flushed by destructor
+
+  EXPECT_EQ(read_whole_file(file), "2 0 18446744073709551615 -7\n");
+  std::fclose(file);
+}
+
+TEST(OutputWriter, OutputLargerThanBuffer) {
+  std::FILE* file = std::tmpfile();
+  std::string expected;
+  {
+    solution::output_writer_t writer(fileno(file));
+    for (int number = 0; number < 100000; ++number) {
+      writer.write(number);
+      expected += std::to_string(number) + " ";
+    }
+    writer.flush();
+  }
+
+  EXPECT_EQ(read_whole_file(file), expected);
+  std::fclose(file);
+}
+
+TEST(OutputWriter, RawBytesLargerThanBuffer) {
+  std::FILE* file = std::tmpfile();
+  std::string expected;
+  {
+    solution::output_writer_t writer(fileno(file));
+    writer.write(1);
+    expected += "1 ";
+    const std::string chunk(100000, 'x');
+    writer.write_raw(chunk.data(), chunk.size());
+    expected += chunk;
+    writer.write_raw("\0k", 2);
+    expected += std::string("\0k", 2);
+  }
+
+  EXPECT_EQ(read_whole_file(file), expected);
+  std::fclose(file);
+}
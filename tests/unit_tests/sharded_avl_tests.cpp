@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "concurrent/sharded_avl.hpp"
+
+namespace {
+
+std::size_t count_in_set(const std::set<int>& keys, int low_key, int high_key) {
+  if (high_key < low_key) {
+    return 0;
+  }
+
+  return std::distance(keys.lower_bound(low_key), keys.upper_bound(high_key));
+}
+
+} // namespace
+
+TEST(RangePartition, SingleShardByDefault) {
+  range_partition_t<int> partition;
+  EXPECT_EQ(partition.shards_count(), 1);
+  EXPECT_EQ(partition.shard_of(-100), 0);
+  EXPECT_EQ(partition.shard_of(100),  0);
+}
+
+TEST(RangePartition, ExplicitBoundaries) {
+  range_partition_t<int> partition({10, 20});
+  EXPECT_EQ(partition.shards_count(), 3);
+  EXPECT_EQ(partition.shard_of(9),  0);
+  EXPECT_EQ(partition.shard_of(10), 1);
+  EXPECT_EQ(partition.shard_of(19), 1);
+  EXPECT_EQ(partition.shard_of(20), 2);
+}
+
+TEST(RangePartition, Uniform) {
+  auto partition = range_partition_t<int>::uniform(0, 100, 4);
+  EXPECT_EQ(partition.boundaries(), std::vector<int>({25, 50, 75}));
+}
+
+TEST(RangePartition, FromSampleQuantiles) {
+  std::vector<int> sample;
+  for (int key = 0; key < 1000; ++key) {
+    sample.push_back(key * key); // skewed keys
+  }
+
+  auto partition = range_partition_t<int>::from_sample(sample.rbegin(), sample.rend(), 4);
+  EXPECT_EQ(partition.boundaries(), std::vector<int>({250 * 250, 500 * 500, 750 * 750}));
+
+  std::vector<int> shard_sizes(partition.shards_count());
+  for (int key : sample) {
+    ++shard_sizes[partition.shard_of(key)];
+  }
+  EXPECT_EQ(shard_sizes, std::vector<int>({250, 250, 250, 250}));
+}
+
+TEST(RangePartition, EmptySampleGivesSingleShard) {
+  std::vector<int> sample;
+  auto partition = range_partition_t<int>::from_sample(sample.begin(), sample.end(), 8);
+  EXPECT_EQ(partition.shards_count(), 1);
+}
+
+TEST(ShardedAVL, EmptyService) {
+  sharded_avl_t<int> service(range_partition_t<int>({0, 100}));
+  EXPECT_EQ(service.shards_count(), 3);
+  EXPECT_EQ(service.size(), 0);
+  EXPECT_EQ(service.count_range(-1000, 1000), 0);
+}
+
+TEST(ShardedAVL, RangesAcrossShards) {
+  sharded_avl_t<int> service(range_partition_t<int>({10, 20, 30}));
+  for (int key : {5, 10, 15, 20, 25, 30, 35, 15}) {
+    service.insert(key);
+  }
+
+  EXPECT_EQ(service.size(), 7);
+  EXPECT_EQ(service.count_range(0,  100), 7);
+  EXPECT_EQ(service.count_range(12, 27),  3);
+  EXPECT_EQ(service.count_range(15, 15),  1);
+  EXPECT_EQ(service.count_range(27, 12),  0);
+
+  service.erase(20);
+  service.erase(21);
+  EXPECT_EQ(service.count_range(12, 27), 2);
+  EXPECT_EQ(service.count_range_batch({{0, 9}, {10, 19}, {30, 40}, {40, 30}}),
+            std::vector<std::size_t>({1, 2, 2, 0}));
+}
+
+class ShardedAVLRandom : public ::testing::TestWithParam<std::pair<std::size_t, std::size_t>> {};
+
+// (shards count, batch size)
+INSTANTIATE_TEST_SUITE_P(ShardsAndBatches, ShardedAVLRandom, ::testing::Values(
+  std::make_pair(1, 256), std::make_pair(4, 1), std::make_pair(7, 3), std::make_pair(16, 64)
+));
+
+TEST_P(ShardedAVLRandom, MatchesSet) {
+  const auto [shards_count, batch_size] = GetParam();
+  std::mt19937 rng(static_cast<unsigned>(shards_count * 1000 + batch_size));
+  std::uniform_int_distribution<int> key_distr(-5000, 5000);
+
+  std::vector<int> sample;
+  for (int sample_ind = 0; sample_ind < 200; ++sample_ind) {
+    sample.push_back(key_distr(rng));
+  }
+  sharded_avl_t<int> service(
+    range_partition_t<int>::from_sample(sample.begin(), sample.end(), shards_count), batch_size
+  );
+  std::set<int> keys;
+
+  for (int round = 0; round < 20; ++round) {
+    for (int update_ind = 0; update_ind < 500; ++update_ind) {
+      const int key = key_distr(rng);
+      if (rng() % 4 == 0) {
+        service.erase(key);
+        keys.erase(key);
+      } else {
+        service.insert(key);
+        keys.insert(key);
+      }
+    }
+
+    std::vector<std::pair<int, int>> ranges;
+    std::vector<std::size_t> expected_answers;
+    for (int query_ind = 0; query_ind < 50; ++query_ind) {
+      ranges.emplace_back(key_distr(rng), key_distr(rng));
+      expected_answers.push_back(count_in_set(keys, ranges.back().first, ranges.back().second));
+    }
+    ASSERT_EQ(service.count_range_batch(ranges), expected_answers);
+    ASSERT_EQ(service.count_range(ranges[0].first, ranges[0].second), expected_answers[0]);
+  }
+  EXPECT_EQ(service.size(), keys.size());
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "solutions/input_reader.hpp"
+#include "solutions/output_writer.hpp"
+#include "workload/workload_generator.hpp"
+
+namespace {
+
+std::vector<workload::query_t> generate_all(const workload::workload_config_t& config) {
+  workload::workload_generator_t generator(config);
+  std::vector<workload::query_t> queries;
+  while (generator.has_next()) {
+    queries.push_back(generator.next());
+  }
+
+  return queries;
+}
+
+bool are_equal(const workload::query_t& lhs, const workload::query_t& rhs) {
+  return lhs.type == rhs.type && lhs.low_key == rhs.low_key && lhs.high_key == rhs.high_key;
+}
+
+} // namespace
+
+TEST(WorkloadGenerator, ParsesDistributionNames) {
+  EXPECT_EQ(workload::parse_distribution("hot-range"), workload::distribution_t::kHotRange);
+  EXPECT_EQ(workload::parse_distribution("drifting"),  workload::distribution_t::kDrifting);
+  EXPECT_FALSE(workload::parse_distribution("gauss").has_value());
+}
+
+TEST(WorkloadGenerator, SameSeedGivesSameStream) {
+  workload::workload_config_t config;
+  config.queries_count = 1000;
+  config.distribution  = workload::distribution_t::kZipf;
+  config.erase_share   = 0.2;
+
+  const auto queries = generate_all(config);
+  const auto same_queries = generate_all(config);
+  ASSERT_EQ(queries.size(), 1000);
+  for (std::size_t query_ind = 0; query_ind < queries.size(); ++query_ind) {
+    EXPECT_TRUE(are_equal(queries[query_ind], same_queries[query_ind]));
+  }
+
+  config.seed += 1;
+  const auto other_queries = generate_all(config);
+  std::size_t equal_count = 0;
+  for (std::size_t query_ind = 0; query_ind < queries.size(); ++query_ind) {
+    equal_count += are_equal(queries[query_ind], other_queries[query_ind]);
+  }
+  EXPECT_LT(equal_count, 500);
+}
+
+TEST(WorkloadGenerator, AllDistributionsRespectConfig) {
+  for (auto distribution : {workload::distribution_t::kUniform,   workload::distribution_t::kZipf,
+                            workload::distribution_t::kSorted,    workload::distribution_t::kSawtooth,
+                            workload::distribution_t::kHotRange,  workload::distribution_t::kClustered,
+                            workload::distribution_t::kDrifting}) {
+    workload::workload_config_t config;
+    config.queries_count   = 20000;
+    config.distribution    = distribution;
+    config.insert_share    = 0.5;
+    config.erase_share     = 0.2;
+    config.min_key         = -1000;
+    config.max_key         = 1000;
+    config.max_range_width = 100;
+
+    std::size_t inserts_count = 0;
+    std::size_t erases_count  = 0;
+    for (const auto& query : generate_all(config)) {
+      ASSERT_GE(query.low_key, config.min_key);
+      ASSERT_LE(query.low_key, config.max_key);
+      if (query.type == 'q') {
+        ASSERT_GE(query.high_key, query.low_key);
+        ASSERT_LE(query.high_key, std::min<std::int64_t>(query.low_key + 100, config.max_key));
+      }
+      inserts_count += query.type == 'k';
+      erases_count  += query.type == 'd';
+    }
+    EXPECT_NEAR(inserts_count, 10000, 500);
+    EXPECT_NEAR(erases_count,  4000,  400);
+  }
+}
+
+TEST(WorkloadGenerator, SortedKeysGrowAlongStream) {
+  workload::workload_config_t config;
+  config.queries_count = 5000;
+  config.distribution  = workload::distribution_t::kSorted;
+  config.min_key       = 0;
+  config.max_key       = 4999;
+
+  const auto queries = generate_all(config);
+  EXPECT_EQ(queries.front().low_key, 0);
+  for (std::size_t query_ind = 1; query_ind < queries.size(); ++query_ind) {
+    EXPECT_GE(queries[query_ind].low_key, queries[query_ind - 1].low_key);
+  }
+}
+
+TEST(WorkloadGenerator, TextAndBinaryOutputsAreReadBack) {
+  workload::workload_config_t config;
+  config.queries_count = 3000;
+  config.distribution  = workload::distribution_t::kClustered;
+  config.erase_share   = 0.1;
+  const auto queries = generate_all(config);
+
+  for (bool is_binary : {false, true}) {
+    std::FILE* file = std::tmpfile();
+    {
+      solution::output_writer_t output(fileno(file));
+      if (is_binary) {
+        workload::binary_query_writer_t writer(output, queries.size(), sizeof(std::int32_t));
+        for (const auto& query : queries) {
+          writer.write(query);
+        }
+      } else {
+        workload::text_query_writer_t writer(output);
+        for (const auto& query : queries) {
+          writer.write(query);
+        }
+      }
+    }
+    std::rewind(file);
+
+    solution::input_reader_t input(fileno(file));
+    for (const auto& query : queries) {
+      char type = 0;
+      int low_key = 0;
+      ASSERT_TRUE(input.read(type));
+      ASSERT_TRUE(input.read(low_key));
+      EXPECT_EQ(type, query.type);
+      EXPECT_EQ(low_key, query.low_key);
+      if (type == 'q') {
+        int high_key = 0;
+        ASSERT_TRUE(input.read(high_key));
+        EXPECT_EQ(high_key, query.high_key);
+      }
+    }
+    char type = 0;
+    EXPECT_FALSE(input.read(type));
+    std::fclose(file);
+  }
+}